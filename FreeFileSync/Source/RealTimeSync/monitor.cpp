@@ -19,6 +19,7 @@ using namespace zen;
 namespace
 {
 const std::chrono::seconds FOLDER_EXISTENCE_CHECK_INTERVAL(1);
+const std::chrono::seconds DISCARD_CHANGES_TIME_MAX(2); //don't hang if someone keeps writing into the watched folders
 
 
 //wait until all directories become available (again) + logs in network share
@@ -118,26 +119,31 @@ struct WaitResult
 };
 
 
-WaitResult waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths, //throw FileError
+//keep watching between command executions: creating a DirWatcher traverses the complete folder tree
+using FolderWatchers = std::map<Zstring, std::unique_ptr<DirWatcher>, LessNativePath>; //folder path => watcher
+
+
+WaitResult waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths, FolderWatchers& watches, //throw FileError
                           const std::function<void(bool readyForSync)>& requestUiRefresh, std::chrono::milliseconds cbInterval)
 {
     assert(std::all_of(folderPaths.begin(), folderPaths.end(), [](const Zstring& folderPath) { return dirAvailable(folderPath); }));
     if (folderPaths.empty()) //pathological case, but we have to check else this function will wait endlessly
         throw FileError(_("A folder input field is empty.")); //should have been checked by caller!
 
-    std::vector<std::pair<Zstring, std::unique_ptr<DirWatcher>>> watches;
+    eraseIf(watches, [&](const auto& item) { return folderPaths.find(item.first) == folderPaths.end(); });
 
     for (const Zstring& folderPath : folderPaths)
-        try
-        {
-            watches.emplace_back(folderPath, std::make_unique<DirWatcher>(folderPath)); //throw FileError
-        }
-        catch (FileError&)
-        {
-            if (!dirAvailable(folderPath)) //folder not existing or can't access
-                return WaitResult(folderPath);
-            throw;
-        }
+        if (watches.find(folderPath) == watches.end())
+            try
+            {
+                watches.emplace(folderPath, std::make_unique<DirWatcher>(folderPath)); //throw FileError
+            }
+            catch (FileError&)
+            {
+                if (!dirAvailable(folderPath)) //folder not existing or can't access
+                    return WaitResult(folderPath);
+                throw;
+            }
 
     auto lastCheckTime = std::chrono::steady_clock::now();
     for (;;)
@@ -153,12 +159,16 @@ WaitResult waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths,
             return false;
         }();
 
-        for (const auto& [folderPath, watcher] : watches)
+        for (auto& [folderPath, watcher] : watches)
         {
             //IMPORTANT CHECK: DirWatcher has problems detecting removal of top watched directories!
             if (checkDirNow)
                 if (!dirAvailable(folderPath)) //catch errors related to directory removal, e.g. ERROR_NETNAME_DELETED
-                    return WaitResult(folderPath);
+                {
+                    const Zstring missingFolderPath = folderPath;
+                    watches.erase(missingFolderPath); //watch needs to be recreated once the folder is back
+                    return WaitResult(missingFolderPath);
+                }
             try
             {
                 std::vector<DirWatcher::Entry> changedItems = watcher->getChanges([&] { requestUiRefresh(false /*readyForSync*/); /*throw X*/ },
@@ -168,6 +178,7 @@ WaitResult waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths,
                     return
                         endsWith(e.itemPath, Zstr(".ffs_tmp"))  || //sync.8ea2.ffs_tmp
                         endsWith(e.itemPath, Zstr(".ffs_lock")) || //sync.ffs_lock, sync.Del.ffs_lock
+                        endsWith(e.itemPath, Zstr(".ffs_hash")) || //sync.ffs_hash
                         endsWith(e.itemPath, Zstr(".ffs_db"));     //sync.ffs_db
                     //no need to ignore temporary recycle bin directory: this must be caused by a file deletion anyway
                 });
@@ -175,10 +186,19 @@ WaitResult waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths,
                 if (!changedItems.empty())
                     return WaitResult(changedItems[0]); //directory change detected
             }
+            catch (ErrorWatchOverflow&) //changes were lost: report *something*
+            {
+                const Zstring overflowFolderPath = folderPath;
+                watches.erase(overflowFolderPath); //recreate including all subfolder watches during next waitForChanges()
+                return WaitResult(DirWatcher::Entry{ DirWatcher::ACTION_UPDATE, overflowFolderPath });
+            }
             catch (FileError&)
             {
-                if (!dirAvailable(folderPath)) //a benign(?) race condition with FileError
-                    return WaitResult(folderPath);
+                const Zstring failedFolderPath = folderPath;
+                watches.erase(failedFolderPath); //watched folders may be out of sync: recreate
+
+                if (!dirAvailable(failedFolderPath)) //a benign(?) race condition with FileError
+                    return WaitResult(failedFolderPath);
                 throw;
             }
         }
@@ -189,6 +209,25 @@ WaitResult waitForChanges(const std::set<Zstring, LessNativePath>& folderPaths,
 }
 
 
+//ignore changes detected so far, e.g. caused by the external command itself
+void discardChanges(FolderWatchers& watches, const std::function<void()>& requestUiRefresh, std::chrono::milliseconds cbInterval)
+{
+    const auto stopTime = std::chrono::steady_clock::now() + DISCARD_CHANGES_TIME_MAX;
+    //ErrorWatchOverflow: recreating the watcher also drops the pending changes
+
+    for (auto it = watches.begin(); it != watches.end();)
+        try
+        {
+            while (!it->second->getChanges(requestUiRefresh, cbInterval).empty() && //throw FileError
+                   std::chrono::steady_clock::now() < stopTime)
+                ;
+            ++it;
+        }
+        catch (FileError&) { it = watches.erase(it); } //recreate during next waitForChanges()
+    //changes still pending after stopTime: not caused by the command => trigger next execution
+}
+
+
 inline
 std::wstring getActionName(DirWatcher::ActionType type)
 {
@@ -223,6 +262,7 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
         try
         {
             std::set<Zstring, LessNativePath> folderPaths = waitForMissingDirs(folderPathPhrases, [&](const Zstring& folderPath) { requestUiRefresh(&folderPath); }, cbInterval); //throw FileError
+            FolderWatchers watches;
 
             //schedule initial execution (*after* all directories have arrived)
             auto nextExecTime = std::chrono::steady_clock::now() + delay;
@@ -234,7 +274,7 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
                 {
                     for (;;) //detected changes
                     {
-                        const WaitResult res = waitForChanges(folderPaths, [&](bool readyForSync) //throw FileError, ExecCommandNowException
+                        const WaitResult res = waitForChanges(folderPaths, watches, [&](bool readyForSync) //throw FileError, ExecCommandNowException
                         {
                             requestUiRefresh(nullptr);
 
@@ -259,6 +299,8 @@ void rts::monitorDirectories(const std::vector<Zstring>& folderPathPhrases, std:
 
                 executeExternalCommand(lastChangeDetected.itemPath, getActionName(lastChangeDetected.action));
                 nextExecTime = std::chrono::steady_clock::time_point::max();
+
+                discardChanges(watches, [&] { requestUiRefresh(nullptr); }, cbInterval);
             }
         }
         catch (const FileError& e)
@@ -316,7 +316,7 @@ private:
     {
         for (FilePair& file : hierObj.refSubFiles())
         {
-            auto getDbEntry = [](const InSyncFolder* dbFolder, const Zstring& fileName) -> const InSyncFile*
+            auto getDbEntry = [](const InSyncFolder* dbFolder, const ZstringNorm& fileName) -> const InSyncFile*
             {
                 if (dbFolder)
                 {
@@ -355,7 +355,7 @@ private:
 
         for (FolderPair& folder : hierObj.refSubFolders())
         {
-            auto getDbEntry = [](const InSyncFolder* dbFolder, const Zstring& folderName) -> const InSyncFolder*
+            auto getDbEntry = [](const InSyncFolder* dbFolder, const ZstringNorm& folderName) -> const InSyncFolder*
             {
                 if (dbFolder)
                 {
@@ -365,10 +365,12 @@ private:
                 }
                 return nullptr;
             };
-            const InSyncFolder* dbEntryL = getDbEntry(dbFolderL, folder.getItemName<LEFT_SIDE>());
+            const ZstringNorm itemNameL = folder.getItemName< LEFT_SIDE>();
+            const ZstringNorm itemNameR = folder.getItemName<RIGHT_SIDE>();
+            const InSyncFolder* dbEntryL = getDbEntry(dbFolderL, itemNameL);
             const InSyncFolder* dbEntryR = dbEntryL;
-            if (dbFolderL != dbFolderR || getUnicodeNormalForm(folder.getItemName<LEFT_SIDE>()) != getUnicodeNormalForm(folder.getItemName<RIGHT_SIDE>()))
-                dbEntryR = getDbEntry(dbFolderR, folder.getItemName<RIGHT_SIDE>());
+            if (dbFolderL != dbFolderR || itemNameL.norm != itemNameR.norm)
+                dbEntryR = getDbEntry(dbFolderR, itemNameR);
 
             recurse(folder, dbEntryL, dbEntryR);
         }
@@ -515,7 +517,7 @@ private:
         //####################################################################################
 
         //try to find corresponding database entry
-        auto getDbEntry = [](const InSyncFolder* dbFolder, const Zstring& fileName) -> const InSyncFile*
+        auto getDbEntry = [](const InSyncFolder* dbFolder, const ZstringNorm& fileName) -> const InSyncFile*
         {
             if (dbFolder)
             {
@@ -525,10 +527,12 @@ private:
             }
             return nullptr;
         };
-        const InSyncFile* dbEntryL = getDbEntry(dbFolderL, file.getItemName<LEFT_SIDE>());
+        const ZstringNorm itemNameL = file.getItemName< LEFT_SIDE>(); //normalize once: reused for lookup and comparison
+        const ZstringNorm itemNameR = file.getItemName<RIGHT_SIDE>(); //
+        const InSyncFile* dbEntryL = getDbEntry(dbFolderL, itemNameL);
         const InSyncFile* dbEntryR = dbEntryL;
-        if (dbFolderL != dbFolderR || getUnicodeNormalForm(file.getItemName<LEFT_SIDE>()) != getUnicodeNormalForm(file.getItemName<RIGHT_SIDE>()))
-            dbEntryR = getDbEntry(dbFolderR, file.getItemName<RIGHT_SIDE>());
+        if (dbFolderL != dbFolderR || itemNameL.norm != itemNameR.norm)
+            dbEntryR = getDbEntry(dbFolderR, itemNameR);
 
         //evaluation
         const bool changeOnLeft  = !matchesDbEntry< LEFT_SIDE>(file, dbEntryL, ignoreTimeShiftMinutes_);
@@ -559,7 +563,7 @@ private:
             return;
 
         //try to find corresponding database entry
-        auto getDbEntry = [](const InSyncFolder* dbFolder, const Zstring& linkName) -> const InSyncSymlink*
+        auto getDbEntry = [](const InSyncFolder* dbFolder, const ZstringNorm& linkName) -> const InSyncSymlink*
         {
             if (dbFolder)
             {
@@ -569,10 +573,12 @@ private:
             }
             return nullptr;
         };
-        const InSyncSymlink* dbEntryL = getDbEntry(dbFolderL, symlink.getItemName<LEFT_SIDE>());
+        const ZstringNorm itemNameL = symlink.getItemName< LEFT_SIDE>();
+        const ZstringNorm itemNameR = symlink.getItemName<RIGHT_SIDE>();
+        const InSyncSymlink* dbEntryL = getDbEntry(dbFolderL, itemNameL);
         const InSyncSymlink* dbEntryR = dbEntryL;
-        if (dbFolderL != dbFolderR || getUnicodeNormalForm(symlink.getItemName<LEFT_SIDE>()) != getUnicodeNormalForm(symlink.getItemName<RIGHT_SIDE>()))
-            dbEntryR = getDbEntry(dbFolderR, symlink.getItemName<RIGHT_SIDE>());
+        if (dbFolderL != dbFolderR || itemNameL.norm != itemNameR.norm)
+            dbEntryR = getDbEntry(dbFolderR, itemNameR);
 
         //evaluation
         const bool changeOnLeft  = !matchesDbEntry< LEFT_SIDE>(symlink, dbEntryL, ignoreTimeShiftMinutes_);
@@ -608,7 +614,7 @@ private:
         //#######################################################################################
 
         //try to find corresponding database entry
-        auto getDbEntry = [](const InSyncFolder* dbFolder, const Zstring& folderName) -> const InSyncFolder*
+        auto getDbEntry = [](const InSyncFolder* dbFolder, const ZstringNorm& folderName) -> const InSyncFolder*
         {
             if (dbFolder)
             {
@@ -618,10 +624,12 @@ private:
             }
             return nullptr;
         };
-        const InSyncFolder* dbEntryL = getDbEntry(dbFolderL, folder.getItemName<LEFT_SIDE>());
+        const ZstringNorm itemNameL = folder.getItemName< LEFT_SIDE>();
+        const ZstringNorm itemNameR = folder.getItemName<RIGHT_SIDE>();
+        const InSyncFolder* dbEntryL = getDbEntry(dbFolderL, itemNameL);
         const InSyncFolder* dbEntryR = dbEntryL;
-        if (dbFolderL != dbFolderR || getUnicodeNormalForm(folder.getItemName<LEFT_SIDE>()) != getUnicodeNormalForm(folder.getItemName<RIGHT_SIDE>()))
-            dbEntryR = getDbEntry(dbFolderR, folder.getItemName<RIGHT_SIDE>());
+        if (dbFolderL != dbFolderR || itemNameL.norm != itemNameR.norm)
+            dbEntryR = getDbEntry(dbFolderR, itemNameR);
 
         if (cat != DIR_EQUAL)
         {
@@ -1284,7 +1292,7 @@ void copyToAlternateFolderFrom(const std::vector<const FileSystemObject*>& rowsT
                     callback.requestUiRefresh(); //throw X
                 };
                 /*const AFS::FileCopyResult result =*/ AFS::copyFileTransactional(sourcePath, sourceAttr, targetPath, //throw FileError, ErrorFileLocked, X
-                                                                                  false /*copyFilePermissions*/, true /*transactionalCopy*/, deleteTargetItem, notifyUnbufferedIO);
+                                                                                  false /*copyFilePermissions*/, true /*transactionalCopy*/, 1 /*stripeCount*/, deleteTargetItem, notifyUnbufferedIO);
                 //result.errorModTime? => probably irrelevant (behave like Windows Explorer)
             });
             statReporter.reportDelta(1, 0);
@@ -1684,7 +1692,7 @@ void TempFileBuffer::createTempFiles(const std::set<FileDescriptor>& workLoad, P
             };
             /*const AFS::FileCopyResult result =*/ AFS::copyFileTransactional(descr.path, sourceAttr, //throw FileError, ErrorFileLocked, X
                                                                               createItemPathNative(tempFilePath),
-                                                                              false /*copyFilePermissions*/, true /*transactionalCopy*/, nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
+                                                                              false /*copyFilePermissions*/, true /*transactionalCopy*/, 1 /*stripeCount*/, nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
             //result.errorModTime? => irrelevant for temp files!
             statReporter.reportDelta(1, 0);
 
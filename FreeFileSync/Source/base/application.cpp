@@ -561,6 +561,7 @@ void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& bat
         //COMPARE DIRECTORIES
         FolderComparison cmpResult = compare(globalCfg.warnDlgs,
                                              globalCfg.fileTimeTolerance,
+                                             globalCfg.cacheContentHashes,
                                              showPopupAllowed, //allowUserInteraction
                                              globalCfg.runWithBackgroundPriority,
                                              globalCfg.createLockFile,
@@ -574,10 +575,13 @@ void runBatchMode(const Zstring& globalConfigFilePath, const XmlBatchConfig& bat
                     globalCfg.copyLockedFiles,
                     globalCfg.copyFilePermissions,
                     globalCfg.failSafeFileCopy,
+                    globalCfg.stripedCopyMinSizeMB,
+                    globalCfg.streamingIO,
                     globalCfg.runWithBackgroundPriority,
                     extractSyncCfg(batchCfg.mainCfg),
                     cmpResult,
                     deviceParallelOps,
+                    batchCfg.mainCfg.deviceParallelWrites,
                     globalCfg.warnDlgs,
                     statusHandler); //throw AbortProcess
     }
@@ -7,6 +7,8 @@
 #include "binary.h"
 #include <vector>
 #include <chrono>
+#include <cstring>
+#include <zen/thread.h>
 
 using namespace zen;
 using namespace fff;
@@ -20,6 +22,8 @@ namespace
     => buffered   access: same perf
     => unbuffered access: same perf on USB stick, file mapping 30% slower on local disk
 
+   Linux: mmap() is no alternative either: file being truncated by another process while we compare => SIGBUS => crash
+
 2. Tests on Win7 x64 show that buffer size does NOT matter if files are located on different physical disks!
 
 Impact of buffer size when files are on same disk:
@@ -36,6 +40,11 @@ Impact of buffer size when files are on same disk:
 */
 const size_t BLOCK_SIZE_MAX =  16 * 1024 * 1024;
 
+//fileSamplesMatch(): ~0.75 MB random reads for both files => not worth it for small files that are read in a few blocks anyway
+const size_t   SAMPLE_BLOCK_SIZE    = 64 * 1024;
+const size_t   SAMPLE_BLOCK_COUNT   = 6; //first, last + evenly spaced in between
+const uint64_t SAMPLE_FILE_SIZE_MIN = 32 * 1024 * 1024;
+
 
 struct StreamReader
 {
@@ -44,23 +53,23 @@ struct StreamReader
         defaultBlockSize_(stream_->getBlockSize()),
         dynamicBlockSize_(defaultBlockSize_) { assert(defaultBlockSize_ > 0); }
 
-    void appendChunk(std::vector<std::byte>& buffer) //throw FileError, X
+    //read into start of buffer; buffer only grows => no reallocation + zero-initialization in steady state
+    size_t readChunk(std::vector<std::byte>& buffer) //throw FileError, X
     {
         assert(!eof_);
-        if (eof_) return;
+        if (eof_) return 0;
 
-        buffer.resize(buffer.size() + dynamicBlockSize_);
+        if (buffer.size() < dynamicBlockSize_)
+            buffer.resize(dynamicBlockSize_);
 
         const auto startTime = std::chrono::steady_clock::now();
-        const size_t bytesRead = stream_->read(&*(buffer.end() - dynamicBlockSize_), dynamicBlockSize_); //throw FileError, ErrorFileLocked, X; return "bytesToRead" bytes unless end of stream!
+        const size_t bytesRead = stream_->read(&buffer[0], dynamicBlockSize_); //throw FileError, ErrorFileLocked, X; return "bytesToRead" bytes unless end of stream!
         const auto stopTime = std::chrono::steady_clock::now();
 
-        buffer.resize(buffer.size() - dynamicBlockSize_ + bytesRead); //caveat: unsigned arithmetics
-
         if (bytesRead < dynamicBlockSize_)
         {
             eof_ = true;
-            return;
+            return bytesRead;
         }
 
         size_t proposedBlockSize = 0;
@@ -80,6 +89,8 @@ struct StreamReader
 
         if (defaultBlockSize_ <= proposedBlockSize && proposedBlockSize <= BLOCK_SIZE_MAX)
             dynamicBlockSize_ = proposedBlockSize;
+
+        return bytesRead;
     }
 
     bool isEof() const { return eof_; }
@@ -91,53 +102,276 @@ private:
     std::chrono::steady_clock::time_point lastDelayViolation_ = std::chrono::steady_clock::now();
     bool eof_ = false;
 };
-}
 
 
-bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IOCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+class SyncBlockSource //read on calling thread
 {
-    int64_t totalUnbufferedIO = 0;
+public:
+    SyncBlockSource(const AbstractPath& filePath, const IOCallback& notifyUnbufferedIO) : reader_(filePath, notifyUnbufferedIO) {} //throw FileError
 
-    StreamReader reader1(filePath1, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError
-    StreamReader reader2(filePath2, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //
+    //return empty block at end of stream
+    std::pair<const std::byte*, size_t> nextBlock() //throw FileError, X
+    {
+        if (reader_.isEof())
+            return { nullptr, 0 };
 
-    StreamReader* readerLow  = &reader1;
-    StreamReader* readerHigh = &reader2;
+        const size_t bytesRead = reader_.readChunk(buf_); //throw FileError, X
+        return { &buf_[0], bytesRead };
+    }
 
-    std::vector<std::byte> bufferLow;
-    std::vector<std::byte> bufferHigh;
+private:
+    StreamReader reader_;
+    std::vector<std::byte> buf_;
+};
 
-    for (;;)
+
+/*  read ahead on a worker thread => both devices are busy at the same time instead of taking turns
+    - first block is read on calling thread: no thread creation for small files
+    - IOCallback is not thread-safe: worker only counts the bytes, calling thread reports them in nextBlock()
+    - bounded buffer: at most PREFETCH_BLOCKS blocks read in advance                                        */
+class PrefetchBlockSource
+{
+public:
+    PrefetchBlockSource(const AbstractPath& filePath, const IOCallback& notifyUnbufferedIO) : //throw FileError
+        notifyUnbufferedIO_(notifyUnbufferedIO),
+        reader_(filePath, [&bytesPending = bytesPending_](int64_t bytesDelta) { bytesPending += bytesDelta; }) {}
+
+    ~PrefetchBlockSource()
+    {
+        if (worker_.joinable())
+        {
+            worker_.interrupt();
+            worker_.join();
+        }
+    }
+
+    //return empty block at end of stream
+    std::pair<const std::byte*, size_t> nextBlock() //throw FileError, X
     {
-        readerLow->appendChunk(bufferLow); //throw FileError, X
+        ZEN_ON_SCOPE_SUCCESS(reportBytesRead()); //throw X
 
-        if (bufferLow.size() > bufferHigh.size())
+        if (!worker_.joinable())
         {
-            bufferLow.swap(bufferHigh);
-            std::swap(readerLow, readerHigh);
+            if (!firstBlockDone_)
+            {
+                firstBlockDone_ = true;
+                const size_t bytesRead = reader_.readChunk(current_); //throw FileError, X
+                return { &current_[0], bytesRead };
+            }
+            if (reader_.isEof())
+                return { nullptr, 0 };
+
+            freeBufs_.resize(PREFETCH_BLOCKS); //+ current_
+            worker_ = InterruptibleThread([this] { prefetch(); });
         }
 
-        if (!std::equal(bufferLow. begin(), bufferLow.end(),
-                        bufferHigh.begin()))
-            return false;
+        std::unique_lock dummy(lockBlocks_);
+        freeBufs_.push_back(std::move(current_));
+        conditionBlockFree_.notify_all();
+
+        conditionBlockRead_.wait(dummy, [this] { return !readBlocks_.empty() || eof_ || error_; });
 
-        if (readerLow->isEof())
+        if (!readBlocks_.empty()) //blocks read before an error are still valid
         {
-            if (bufferLow.size() < bufferHigh.size())
-                return false;
-            if (readerHigh->isEof())
-                break;
-            //bufferLow.swap(bufferHigh); not needed
-            std::swap(readerLow, readerHigh);
+            current_ = std::move(readBlocks_.front().first);
+            const size_t bytesRead = readBlocks_.front().second;
+            readBlocks_.pop_front();
+            return { &current_[0], bytesRead };
         }
+        if (error_)
+            std::rethrow_exception(error_); //throw FileError
+        return { nullptr, 0 };
+    }
+
+private:
+    PrefetchBlockSource           (const PrefetchBlockSource&) = delete;
+    PrefetchBlockSource& operator=(const PrefetchBlockSource&) = delete;
 
-        //don't let sliding buffer grow too large
-        bufferHigh.erase(bufferHigh.begin(), bufferHigh.begin() + bufferLow.size());
-        bufferLow.clear();
+    //context of worker thread
+    void prefetch() //throw ThreadInterruption
+    {
+        setCurrentThreadName("Compare Prefetch");
+        try
+        {
+            for (;;)
+            {
+                std::vector<std::byte> buf;
+                {
+                    std::unique_lock dummy(lockBlocks_);
+                    interruptibleWait(conditionBlockFree_, dummy, [this] { return !freeBufs_.empty(); }); //throw ThreadInterruption
+                    buf = std::move(freeBufs_.back());
+                    freeBufs_.pop_back();
+                }
+
+                const size_t bytesRead = reader_.readChunk(buf); //throw FileError
+                interruptionPoint(); //throw ThreadInterruption
+
+                {
+                    std::lock_guard dummy(lockBlocks_);
+                    readBlocks_.push_back(std::make_pair(std::move(buf), bytesRead));
+                    eof_ = reader_.isEof();
+                }
+                conditionBlockRead_.notify_all();
+
+                if (reader_.isEof())
+                    return;
+            }
+        }
+        catch (ThreadInterruption&) { throw; }
+        catch (...)
+        {
+            {
+                std::lock_guard dummy(lockBlocks_);
+                error_ = std::current_exception();
+            }
+            conditionBlockRead_.notify_all();
+        }
+    }
+
+    //context of calling thread
+    void reportBytesRead() //throw X
+    {
+        if (const int64_t bytesDelta = bytesPending_.exchange(0); bytesDelta != 0)
+            if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesDelta); //throw X
     }
 
+    static const size_t PREFETCH_BLOCKS = 2;
+
+    const IOCallback notifyUnbufferedIO_; //throw X
+    std::atomic<int64_t> bytesPending_{ 0 }; //std:atomic is uninitialized by default!
+    StreamReader reader_; //accessed by worker thread once started
+
+    bool firstBlockDone_ = false;
+    std::vector<std::byte> current_; //block currently owned by calling thread
+
+    std::mutex lockBlocks_;
+    std::vector<std::vector<std::byte>> freeBufs_;
+    RingBuffer<std::pair<std::vector<std::byte>, size_t /*bytesRead*/>> readBlocks_;
+    bool eof_ = false;
+    std::exception_ptr error_;
+    std::condition_variable conditionBlockRead_;
+    std::condition_variable conditionBlockFree_;
+
+    InterruptibleThread worker_; //declare last: must not outlive the members above!
+};
+
+
+template <class BlockSource>
+bool haveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IOCallback& notifyUnbufferedIO /*throw X*/, MurmurHash3* hasher) //throw FileError, X
+{
+    BlockSource source1(filePath1, notifyUnbufferedIO); //throw FileError
+    BlockSource source2(filePath2, notifyUnbufferedIO); //
+
+    //each side keeps its unconsumed data [pos, end) => refill a side only after it was fully compared: no need to move data around
+    struct ReadWindow
+    {
+        BlockSource& source;
+        const std::byte* data = nullptr;
+        size_t pos = 0;
+        size_t end = 0;
+    } side1{ source1 }, side2{ source2 };
+
+    for (;;)
+    {
+        for (ReadWindow* side : { &side1, &side2 })
+            if (side->pos == side->end)
+            {
+                std::tie(side->data, side->end) = side->source.nextBlock(); //throw FileError, X
+                side->pos = 0;
+            }
+
+        const size_t bytesAvail1 = side1.end - side1.pos;
+        const size_t bytesAvail2 = side2.end - side2.pos;
+
+        if (bytesAvail1 == 0 || bytesAvail2 == 0) //=> EOF
+            return bytesAvail1 == bytesAvail2;
+
+        //memcmp(): glibc picks SSE2/AVX2/EVEX implementation at runtime (IFUNC) and stops at first difference
+        const size_t bytesToCompare = std::min(bytesAvail1, bytesAvail2);
+        if (std::memcmp(side1.data + side1.pos, side2.data + side2.pos, bytesToCompare) != 0)
+            return false;
+
+        if (hasher) //equal so far => hashing either side's data will do
+            hasher->update(side1.data + side1.pos, bytesToCompare);
+
+        side1.pos += bytesToCompare;
+        side2.pos += bytesToCompare;
+    }
+}
+}
+
+
+bool fff::filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, const IOCallback& notifyUnbufferedIO /*throw X*/, Hash128* contentHash) //throw FileError, X
+{
+    int64_t totalUnbufferedIO = 0;
+
+    const IOCallbackDivider notifyIoDiv(notifyUnbufferedIO, totalUnbufferedIO);
+
+    std::optional<MurmurHash3> hasher;
+    if (contentHash)
+        hasher.emplace();
+
+    //different devices (e.g. local disk vs USB stick or network share) => read both files concurrently
+    //same device => reading in turn is faster than competing for the disk head
+    const bool sameContent = filePath1.afsDevice != filePath2.afsDevice ?
+                             haveSameContent<PrefetchBlockSource>(filePath1, filePath2, notifyIoDiv, hasher ? &*hasher : nullptr) : //throw FileError, X
+                             haveSameContent<SyncBlockSource    >(filePath1, filePath2, notifyIoDiv, hasher ? &*hasher : nullptr);  //
+    if (!sameContent)
+        return false;
+
     if (totalUnbufferedIO % 2 != 0)
         throw std::logic_error("Contract violation! " + std::string(__FILE__) + ":" + numberTo<std::string>(__LINE__));
 
+    if (contentHash)
+        *contentHash = hasher->finalize();
     return true;
 }
+
+
+uint64_t fff::getSampleBytesExpected(uint64_t fileSize)
+{
+    return fileSize < SAMPLE_FILE_SIZE_MIN ? 0 : SAMPLE_BLOCK_SIZE * SAMPLE_BLOCK_COUNT;
+}
+
+
+bool fff::fileSamplesMatch(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize, const IOCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+{
+    if (fileSize < SAMPLE_FILE_SIZE_MIN)
+        return true;
+
+    int64_t totalUnbufferedIO = 0;
+    const IOCallbackDivider notifyIoDiv(notifyUnbufferedIO, totalUnbufferedIO); //report the average of both files, same as filesHaveSameContent()
+
+    //large files often differ at the end only (e.g. media files with appended metadata, interrupted copies)
+    std::vector<uint64_t> offsets;
+    const uint64_t offsetStep = (fileSize - SAMPLE_BLOCK_SIZE) / (SAMPLE_BLOCK_COUNT - 1);
+    for (size_t i = 0; i < SAMPLE_BLOCK_COUNT - 1; ++i)
+        offsets.push_back(i * offsetStep);
+    offsets.push_back(fileSize - SAMPLE_BLOCK_SIZE);
+
+    const std::optional<std::vector<std::byte>> samples1 = AFS::readFileBlocks(filePath1, offsets, SAMPLE_BLOCK_SIZE, notifyIoDiv); //throw FileError, X
+    if (!samples1)
+        return true;
+
+    const std::optional<std::vector<std::byte>> samples2 = AFS::readFileBlocks(filePath2, offsets, SAMPLE_BLOCK_SIZE, notifyIoDiv); //throw FileError, X
+    if (!samples2)
+        return true;
+
+    return *samples1 == *samples2;
+}
+
+
+Hash128 fff::getContentHash(const AbstractPath& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+{
+    SyncBlockSource source(filePath, notifyUnbufferedIO); //throw FileError
+    MurmurHash3 hasher;
+
+    for (;;)
+    {
+        const auto [data, bytesRead] = source.nextBlock(); //throw FileError, X
+        if (bytesRead == 0) //EOF
+            return hasher.finalize();
+
+        hasher.update(data, bytesRead);
+    }
+}
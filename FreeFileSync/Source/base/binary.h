@@ -7,6 +7,7 @@
 #ifndef BINARY_H_3941281398513241134
 #define BINARY_H_3941281398513241134
 
+#include <zen/murmur_hash.h>
 #include "../fs/abstract.h"
 
 
@@ -14,7 +15,17 @@ namespace fff
 {
 bool filesHaveSameContent(const AbstractPath& filePath1, //throw FileError, X
                           const AbstractPath& filePath2,
-                          const zen::IOCallback& notifyUnbufferedIO  /*throw X*/);
+                          const zen::IOCallback& notifyUnbufferedIO  /*throw X*/,
+                          zen::Hash128* contentHash = nullptr); //optional out: set if both files are equal
+
+//quick pre-check for files of equal size: compare a few blocks at the beginning, end and in between
+//=> "false" if content differs; "true" if blocks match, file is too small to bother, or device has no random access
+bool fileSamplesMatch(const AbstractPath& filePath1, //throw FileError, X
+                      const AbstractPath& filePath2, uint64_t fileSize,
+                      const zen::IOCallback& notifyUnbufferedIO /*throw X*/);
+uint64_t getSampleBytesExpected(uint64_t fileSize); //bytes reported by fileSamplesMatch() in addition to a full comparison
+
+zen::Hash128 getContentHash(const AbstractPath& filePath, const zen::IOCallback& notifyUnbufferedIO /*throw X*/); //throw FileError, X
 }
 
 #endif //BINARY_H_3941281398513241134
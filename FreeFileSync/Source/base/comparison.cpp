@@ -5,12 +5,14 @@
 // *****************************************************************************
 
 #include "comparison.h"
+#include <deque>
 #include <zen/process_priority.h>
 #include <zen/perf.h>
 #include "algorithm.h"
 #include "parallel_scan.h"
 #include "dir_exist_async.h"
 #include "db_file.h"
+#include "hash_cache.h"
 #include "binary.h"
 #include "cmp_filetime.h"
 #include "status_handler_impl.h"
@@ -34,9 +36,9 @@ std::vector<FolderPairCfg> fff::extractCompareCfg(const MainConfiguration& mainC
         const SyncConfig syncCfg = lpc.localSyncCfg ? *lpc.localSyncCfg : mainCfg.syncCfg;
         NormalizedFilter filter = normalizeFilters(mainCfg.globalFilter, lpc.localFilter);
 
-        //exclude sync.ffs_db and lock files
+        //exclude sync.ffs_db, sync.ffs_hash and lock files
         //=> can't put inside fff::parallelDeviceTraversal() which is also used by versioning
-        filter.nameFilter = filter.nameFilter.ref().copyFilterAddingExclusion(Zstring(Zstr("*")) + SYNC_DB_FILE_ENDING + Zstr("\n*") + LOCK_FILE_ENDING);
+        filter.nameFilter = filter.nameFilter.ref().copyFilterAddingExclusion(Zstring(Zstr("*")) + SYNC_DB_FILE_ENDING + Zstr("\n*") + CONTENT_HASH_FILE_ENDING + Zstr("\n*") + LOCK_FILE_ENDING);
 
         output.push_back(
         {
@@ -160,6 +162,7 @@ public:
     ComparisonBuffer(const std::set<DirectoryKey>& foldersToRead,
                      const std::map<AfsDevice, size_t>& deviceParallelOps,
                      int fileTimeTolerance,
+                     bool cacheContentHashes,
                      ProcessCallback& callback);
 
     //create comparison result table and fill category except for files existing on both sides: undefinedFiles and undefinedSymlinks are appended!
@@ -178,6 +181,7 @@ private:
 
     std::map<DirectoryKey, DirectoryValue> directoryBuffer_; //contains only *existing* directories
     const int fileTimeTolerance_;
+    const bool cacheContentHashes_;
     ProcessCallback& cb_;
     const std::map<AfsDevice, size_t> deviceParallelOps_;
 };
@@ -186,8 +190,9 @@ private:
 ComparisonBuffer::ComparisonBuffer(const std::set<DirectoryKey>& foldersToRead,
                                    const std::map<AfsDevice, size_t>& deviceParallelOps,
                                    int fileTimeTolerance,
+                                   bool cacheContentHashes,
                                    ProcessCallback& callback) :
-    fileTimeTolerance_(fileTimeTolerance), cb_(callback), deviceParallelOps_(deviceParallelOps)
+    fileTimeTolerance_(fileTimeTolerance), cacheContentHashes_(cacheContentHashes), cb_(callback), deviceParallelOps_(deviceParallelOps)
 {
     auto onError = [&](const std::wstring& msg, size_t retryNumber)
     {
@@ -318,6 +323,59 @@ void categorizeSymlinkByTime(SymlinkPair& symlink)
     }
 }
 
+//-----------------------------------------------------------------------------
+
+size_t getCmpThreadCount() { return std::max<size_t>(std::thread::hardware_concurrency(), 1); } //hardware_concurrency() == 0 if "not computable or well defined"
+
+
+//categorization of an item has no side effects on other items (or parent folders) => process chunks on worker threads
+template <class Item, class Function>
+void categorizeParallel(const std::vector<Item*>& items, Function categorize) //throw std::bad_alloc
+{
+    constexpr size_t CHUNK_SIZE = 10000;
+
+    const size_t threadCount = std::min(getCmpThreadCount(), (items.size() + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    if (threadCount <= 1)
+    {
+        for (Item* item : items)
+            categorize(*item);
+        return;
+    }
+
+    std::mutex lockError;
+    std::exception_ptr firstError;
+    {
+        ThreadGroup<std::function<void()>> tg(threadCount, "Categorize Items");
+
+        for (size_t i = 0; i < items.size(); i += CHUNK_SIZE)
+            tg.run([&, itFirst = items.begin() + i, itLast = items.begin() + std::min(i + CHUNK_SIZE, items.size())]
+            {
+                try
+                {
+                    std::for_each(itFirst, itLast, [&](Item* item) { categorize(*item); });
+                }
+                catch (...) //std::bad_alloc
+                {
+                    std::lock_guard dummy(lockError);
+                    if (!firstError)
+                        firstError = std::current_exception();
+                }
+            });
+        tg.wait();
+    }
+    if (firstError)
+        std::rethrow_exception(firstError); //throw std::bad_alloc
+}
+
+
+//help finding the bottleneck when comparing huge folder trees: only log phases taking noticeable time
+void logPhaseTime(const std::wstring& phaseName, const StopWatch& watch, ProcessCallback& callback)
+{
+    const int64_t timeMs = std::chrono::duration_cast<std::chrono::milliseconds>(watch.elapsed()).count();
+    if (timeMs >= 1000)
+        callback.logInfo(_("Comparison phase:") + L" " + phaseName + L" - " + replaceCpy(_("%x ms"), L"%x", formatNumber(timeMs)));
+}
+
 
 std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareByTimeSize(const ResolvedFolderPair& fp, const FolderPairCfg& fpConfig) const
 {
@@ -326,50 +384,53 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareByTimeSize(const Resolv
     std::vector<SymlinkPair*> uncategorizedLinks;
     std::shared_ptr<BaseFolderPair> output = performComparison(fp, fpConfig, uncategorizedFiles, uncategorizedLinks);
 
+    StopWatch categorizeTime;
+
     //finish symlink categorization
-    for (SymlinkPair* symlink : uncategorizedLinks)
-        categorizeSymlinkByTime(*symlink);
+    categorizeParallel(uncategorizedLinks, [](SymlinkPair& symlink) { categorizeSymlinkByTime(symlink); });
 
     //categorize files that exist on both sides
-    for (FilePair* file : uncategorizedFiles)
+    categorizeParallel(uncategorizedFiles, [&](FilePair& file)
     {
-        switch (compareFileTime(file->getLastWriteTime<LEFT_SIDE>(),
-                                file->getLastWriteTime<RIGHT_SIDE>(), fileTimeTolerance_, fpConfig.ignoreTimeShiftMinutes))
+        switch (compareFileTime(file.getLastWriteTime<LEFT_SIDE>(),
+                                file.getLastWriteTime<RIGHT_SIDE>(), fileTimeTolerance_, fpConfig.ignoreTimeShiftMinutes))
         {
             case TimeResult::EQUAL:
                 //Caveat:
                 //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
                 //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
                 //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
-                if (file->getFileSize<LEFT_SIDE>() == file->getFileSize<RIGHT_SIDE>())
+                if (file.getFileSize<LEFT_SIDE>() == file.getFileSize<RIGHT_SIDE>())
                 {
-                    if (getUnicodeNormalForm(file->getItemName< LEFT_SIDE>()) ==
-                        getUnicodeNormalForm(file->getItemName<RIGHT_SIDE>()))
-                        file->setCategory<FILE_EQUAL>();
+                    if (getUnicodeNormalForm(file.getItemName< LEFT_SIDE>()) ==
+                        getUnicodeNormalForm(file.getItemName<RIGHT_SIDE>()))
+                        file.setCategory<FILE_EQUAL>();
                     else
-                        file->setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(*file));
+                        file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
                 }
                 else
-                    file->setCategoryConflict(getConflictSameDateDiffSize(*file)); //same date, different filesize
+                    file.setCategoryConflict(getConflictSameDateDiffSize(file)); //same date, different filesize
                 break;
 
             case TimeResult::LEFT_NEWER:
-                file->setCategory<FILE_LEFT_NEWER>();
+                file.setCategory<FILE_LEFT_NEWER>();
                 break;
 
             case TimeResult::RIGHT_NEWER:
-                file->setCategory<FILE_RIGHT_NEWER>();
+                file.setCategory<FILE_RIGHT_NEWER>();
                 break;
 
             case TimeResult::LEFT_INVALID:
-                file->setCategoryConflict(getConflictInvalidDate<LEFT_SIDE>(*file));
+                file.setCategoryConflict(getConflictInvalidDate<LEFT_SIDE>(file));
                 break;
 
             case TimeResult::RIGHT_INVALID:
-                file->setCategoryConflict(getConflictInvalidDate<RIGHT_SIDE>(*file));
+                file.setCategoryConflict(getConflictInvalidDate<RIGHT_SIDE>(file));
                 break;
         }
-    }
+    });
+
+    logPhaseTime(_("Categorize differences"), categorizeTime, cb_);
     return output;
 }
 
@@ -429,24 +490,28 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::compareBySize(const ResolvedFo
         categorizeSymlinkByContent(*symlink, cb_); //"compare by size" has the semantics of a quick content-comparison!
     //harmonize with algorithm.cpp, stillInSync()!
 
+    StopWatch categorizeTime;
+
     //categorize files that exist on both sides
-    for (FilePair* file : uncategorizedFiles)
+    categorizeParallel(uncategorizedFiles, [](FilePair& file)
     {
         //Caveat:
         //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
         //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
         //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
-        if (file->getFileSize<LEFT_SIDE>() == file->getFileSize<RIGHT_SIDE>())
+        if (file.getFileSize<LEFT_SIDE>() == file.getFileSize<RIGHT_SIDE>())
         {
-            if (getUnicodeNormalForm(file->getItemName< LEFT_SIDE>()) ==
-                getUnicodeNormalForm(file->getItemName<RIGHT_SIDE>()))
-                file->setCategory<FILE_EQUAL>();
+            if (getUnicodeNormalForm(file.getItemName< LEFT_SIDE>()) ==
+                getUnicodeNormalForm(file.getItemName<RIGHT_SIDE>()))
+                file.setCategory<FILE_EQUAL>();
             else
-                file->setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(*file));
+                file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
         }
         else
-            file->setCategory<FILE_DIFFERENT_CONTENT>();
-    }
+            file.setCategory<FILE_DIFFERENT_CONTENT>();
+    });
+
+    logPhaseTime(_("Categorize differences"), categorizeTime, cb_);
     return output;
 }
 
@@ -459,21 +524,94 @@ namespace parallel
 inline
 bool filesHaveSameContent(const AbstractPath& filePath1, const AbstractPath& filePath2, //throw FileError, X
                           const IOCallback& notifyUnbufferedIO /*throw X*/,
+                          Hash128* contentHash,
                           std::mutex& singleThread)
-{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
+{ return parallelScope([=] { return filesHaveSameContent(filePath1, filePath2, notifyUnbufferedIO, contentHash); /*throw FileError, X*/ }, singleThread); }
+
+inline
+bool fileSamplesMatch(const AbstractPath& filePath1, const AbstractPath& filePath2, uint64_t fileSize, //throw FileError, X
+                      const IOCallback& notifyUnbufferedIO /*throw X*/,
+                      std::mutex& singleThread)
+{ return parallelScope([=] { return fff::fileSamplesMatch(filePath1, filePath2, fileSize, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
+
+inline
+Hash128 getContentHash(const AbstractPath& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/, std::mutex& singleThread) //throw FileError, X
+{ return parallelScope([=] { return fff::getContentHash(filePath, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
 }
 
 
 namespace
 {
-void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingContentOfFiles, AsyncCallback& acb, std::mutex& singleThread) //throw ThreadInterruption
+void setCategoryByContent(FilePair& file, bool haveSameContent)
+{
+    if (haveSameContent)
+    {
+        //Caveat:
+        //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
+        //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
+        //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
+        if (getUnicodeNormalForm(file.getItemName< LEFT_SIDE>()) !=
+            getUnicodeNormalForm(file.getItemName<RIGHT_SIDE>()))
+            file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
+#if 0 //don't synchronize modtime only see FolderPairSyncer::synchronizeFileInt(), SO_COPY_METADATA_TO_*
+        else if (!sameFileTime(file.getLastWriteTime<LEFT_SIDE>(),
+                               file.getLastWriteTime<RIGHT_SIDE>(), file.base().getFileTimeTolerance(), file.base().getIgnoredTimeShift()))
+            file.setCategoryDiffMetadata(getDescrDiffMetaData(file));
+#endif
+        else
+            file.setCategory<FILE_EQUAL>();
+    }
+    else
+        file.setCategory<FILE_DIFFERENT_CONTENT>();
+}
+
+
+//content hashes of one base folder: shared by all folder pairs referencing it
+struct HashCacheFolder
+{
+    ContentHashCache oldHashes; //as loaded
+    ContentHashCache newHashes; //hashes still valid after this comparison
+};
+
+
+//cached hash is only usable if the file has not changed since
+template <SelectedSide side> inline
+const Hash128* getCachedHash(const FilePair& file, const HashCacheFolder& hashCache)
+{
+    auto it = hashCache.oldHashes.find(file.getRelativePath<side>());
+    if (it != hashCache.oldHashes.end() &&
+        it->second.fileId   == file.getFileId       <side>() &&
+        it->second.fileSize == file.getFileSize     <side>() &&
+        it->second.modTime  == file.getLastWriteTime<side>())
+        return &it->second.contentHash;
+    return nullptr;
+}
+
+
+template <SelectedSide side> inline
+void setCachedHash(const FilePair& file, HashCacheFolder& hashCache, const Hash128& contentHash)
+{
+    hashCache.newHashes[file.getRelativePath<side>()] = { file.getFileId<side>(), file.getFileSize<side>(), file.getLastWriteTime<side>(), contentHash };
+}
+
+
+void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingContentOfFiles, AsyncCallback& acb, std::mutex& singleThread, //throw ThreadInterruption
+                             HashCacheFolder* hashCacheL, HashCacheFolder* hashCacheR) //optional
 {
     acb.reportStatus(replaceCpy(txtComparingContentOfFiles, L"%x", fmtPath(file.getRelativePathAny()))); //throw ThreadInterruption
 
+    //at most one side has a valid cached hash: both sides were handled before starting the comparison
+    const Hash128* cachedHashL = hashCacheL ? getCachedHash< LEFT_SIDE>(file, *hashCacheL) : nullptr;
+    const Hash128* cachedHashR = hashCacheR ? getCachedHash<RIGHT_SIDE>(file, *hashCacheR) : nullptr;
+    assert(!cachedHashL || !cachedHashR);
+
     bool haveSameContent = false;
+    std::optional<Hash128> contentHashL;
+    std::optional<Hash128> contentHashR;
+
     const std::wstring errMsg = tryReportingError([&]
     {
-        AsyncItemStatReporter statReporter(1, file.getFileSize<LEFT_SIDE>(), acb);
+        AsyncItemStatReporter statReporter(1, file.getFileSize<LEFT_SIDE>() + getSampleBytesExpected(file.getFileSize<LEFT_SIDE>()), acb);
 
         //callbacks run *outside* singleThread_ lock! => fine
         auto notifyUnbufferedIO = [&statReporter](int64_t bytesDelta)
@@ -482,8 +620,30 @@ void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingCon
             interruptionPoint(); //throw ThreadInterruption
         };
 
-        haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath< LEFT_SIDE>(),
-                                                         file.getAbstractPath<RIGHT_SIDE>(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadInterruption
+        if (cachedHashL) //only right side changed => read it alone
+        {
+            contentHashL = *cachedHashL;
+            contentHashR = parallel::getContentHash(file.getAbstractPath<RIGHT_SIDE>(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadInterruption
+            haveSameContent = *contentHashL == *contentHashR;
+        }
+        else if (cachedHashR)
+        {
+            contentHashR = *cachedHashR;
+            contentHashL = parallel::getContentHash(file.getAbstractPath<LEFT_SIDE>(), notifyUnbufferedIO, singleThread); //throw FileError, ThreadInterruption
+            haveSameContent = *contentHashL == *contentHashR;
+        }
+        else if (!parallel::fileSamplesMatch(file.getAbstractPath< LEFT_SIDE>(), //throw FileError, ThreadInterruption
+                                             file.getAbstractPath<RIGHT_SIDE>(), file.getFileSize<LEFT_SIDE>(), notifyUnbufferedIO, singleThread))
+            haveSameContent = false; //settled without reading the files in full
+        else
+        {
+            Hash128 contentHash;
+            haveSameContent = parallel::filesHaveSameContent(file.getAbstractPath< LEFT_SIDE>(),
+                                                             file.getAbstractPath<RIGHT_SIDE>(), notifyUnbufferedIO,
+                                                             hashCacheL || hashCacheR ? &contentHash : nullptr, singleThread); //throw FileError, ThreadInterruption
+            if (haveSameContent) //content hash is only complete if both files were read until the end
+                contentHashL = contentHashR = contentHash;
+        }
         statReporter.reportDelta(1, 0);
     }, acb); //throw ThreadInterruption
 
@@ -491,25 +651,10 @@ void categorizeFileByContent(FilePair& file, const std::wstring& txtComparingCon
         file.setCategoryConflict(copyStringTo<Zstringw>(errMsg));
     else
     {
-        if (haveSameContent)
-        {
-            //Caveat:
-            //1. FILE_EQUAL may only be set if short names match in case: InSyncFolder's mapping tables use short name as a key! see db_file.cpp
-            //2. FILE_EQUAL is expected to mean identical file sizes! See InSyncFile
-            //3. harmonize with "bool stillInSync()" in algorithm.cpp, FilePair::setSyncedTo() in file_hierarchy.h
-            if (getUnicodeNormalForm(file.getItemName< LEFT_SIDE>()) !=
-                getUnicodeNormalForm(file.getItemName<RIGHT_SIDE>()))
-                file.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(file));
-#if 0 //don't synchronize modtime only see FolderPairSyncer::synchronizeFileInt(), SO_COPY_METADATA_TO_*
-            else if (!sameFileTime(file.getLastWriteTime<LEFT_SIDE>(),
-                                   file.getLastWriteTime<RIGHT_SIDE>(), file.base().getFileTimeTolerance(), file.base().getIgnoredTimeShift()))
-                file.setCategoryDiffMetadata(getDescrDiffMetaData(file));
-#endif
-            else
-                file.setCategory<FILE_EQUAL>();
-        }
-        else
-            file.setCategory<FILE_DIFFERENT_CONTENT>();
+        if (hashCacheL && contentHashL) setCachedHash< LEFT_SIDE>(file, *hashCacheL, *contentHashL);
+        if (hashCacheR && contentHashR) setCachedHash<RIGHT_SIDE>(file, *hashCacheR, *contentHashR);
+
+        setCategoryByContent(file, haveSameContent);
     }
 }
 }
@@ -529,11 +674,34 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
     {
         ParallelOps& parallelOpsL; //
         ParallelOps& parallelOpsR; //consider aliasing!
+        HashCacheFolder* hashCacheL; //
+        HashCacheFolder* hashCacheR; //optional; consider aliasing!
         RingBuffer<FilePair*> filesToCompareBytewise;
     };
     std::vector<BinaryWorkload> fpWorkload;
 
-    auto addToBinaryWorkload = [&](const AbstractPath& basePathL, const AbstractPath& basePathR, RingBuffer<FilePair*>&& filesToCompareBytewise)
+    std::map<AbstractPath, HashCacheFolder> hashCaches;
+
+    auto getHashCache = [&](const AbstractPath& baseFolderPath) -> HashCacheFolder* //throw X
+    {
+        if (!cacheContentHashes_)
+            return nullptr;
+
+        const auto [it, inserted] = hashCaches.try_emplace(baseFolderPath);
+        if (inserted)
+            try
+            {
+                it->second.oldHashes = loadContentHashCache(baseFolderPath); //throw FileError
+            }
+            catch (const FileError& e) //not an error in this context: cache will be rebuilt
+            {
+                cb_.reportInfo(e.toString()); //throw X
+            }
+        return &it->second;
+    };
+
+    auto addToBinaryWorkload = [&](const AbstractPath& basePathL, const AbstractPath& basePathR, HashCacheFolder* hashCacheL, HashCacheFolder* hashCacheR,
+                                   RingBuffer<FilePair*>&& filesToCompareBytewise)
     {
         //calculate effective max parallelOps that devices must support
         const size_t parallelOpsFp = std::max(getDeviceParallelOps(deviceParallelOps_, basePathL.afsDevice),
@@ -545,7 +713,7 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
         posL.effectiveMax = std::max(posL.effectiveMax, parallelOpsFp);
         posR.effectiveMax = std::max(posR.effectiveMax, parallelOpsFp);
 
-        fpWorkload.push_back({ posL, posR, std::move(filesToCompareBytewise) });
+        fpWorkload.push_back({ posL, posR, hashCacheL, hashCacheR, std::move(filesToCompareBytewise) });
     };
 
     //PERF_START;
@@ -560,6 +728,12 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
         //run basis scan and retrieve candidates for binary comparison (files existing on both sides)
         output.push_back(performComparison(folderPair, fpCfg, undefinedFiles, uncategorizedLinks));
 
+        const AbstractPath basePathL = output.back()->getAbstractPath< LEFT_SIDE>();
+        const AbstractPath basePathR = output.back()->getAbstractPath<RIGHT_SIDE>();
+
+        HashCacheFolder* hashCacheL = !undefinedFiles.empty() ? getHashCache(basePathL) : nullptr; //throw X
+        HashCacheFolder* hashCacheR = !undefinedFiles.empty() ? getHashCache(basePathR) : nullptr; //
+
         RingBuffer<FilePair*> filesToCompareBytewise;
         //content comparison of file content happens AFTER finding corresponding files and AFTER filtering
         //in order to separate into two processes (scanning and comparing)
@@ -574,11 +748,23 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
                 if (!file->isActive())
                     file->setCategoryConflict(txtConflictSkippedBinaryComparison);
                 else
+                {
+                    //neither file changed since their content hashes were cached => no need to read them again
+                    if (hashCacheL && hashCacheR)
+                        if (const Hash128* cachedHashL = getCachedHash<LEFT_SIDE>(*file, *hashCacheL))
+                            if (const Hash128* cachedHashR = getCachedHash<RIGHT_SIDE>(*file, *hashCacheR))
+                            {
+                                setCachedHash< LEFT_SIDE>(*file, *hashCacheL, *cachedHashL);
+                                setCachedHash<RIGHT_SIDE>(*file, *hashCacheR, *cachedHashR);
+
+                                setCategoryByContent(*file, *cachedHashL == *cachedHashR);
+                                continue;
+                            }
                     filesToCompareBytewise.push_back(file);
+                }
             }
         if (!filesToCompareBytewise.empty())
-            addToBinaryWorkload(output.back()->getAbstractPath< LEFT_SIDE>(),
-                                output.back()->getAbstractPath<RIGHT_SIDE>(), std::move(filesToCompareBytewise));
+            addToBinaryWorkload(basePathL, basePathR, hashCacheL, hashCacheR, std::move(filesToCompareBytewise));
 
         //finish symlink categorization
         for (SymlinkPair* symlink : uncategorizedLinks)
@@ -595,7 +781,7 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
             itemsTotal += bwl.filesToCompareBytewise.size();
 
             for (const FilePair* file : bwl.filesToCompareBytewise)
-                bytesTotal += file->getFileSize<LEFT_SIDE>(); //left and right file sizes are equal
+                bytesTotal += file->getFileSize<LEFT_SIDE>() + getSampleBytesExpected(file->getFileSize<LEFT_SIDE>()); //left and right file sizes are equal
         }
         cb_.initNewPhase(itemsTotal, bytesTotal, ProcessCallback::PHASE_COMPARING_CONTENT); //throw X
 
@@ -626,7 +812,7 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
 
                 for (size_t i = 0; i < newTaskCount; ++i)
                 {
-                    tg.run([&, statusPrio = j, &file = *bwl.filesToCompareBytewise.front()]
+                    tg.run([&, statusPrio = j, &file = *bwl.filesToCompareBytewise.front(), hashCacheL = bwl.hashCacheL, hashCacheR = bwl.hashCacheR]
                     {
                         acb.notifyTaskBegin(statusPrio); //prioritize status messages according to natural order of folder pairs
                         ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
@@ -637,7 +823,7 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
                                              /**/                --posR.current;
                                              scheduleMoreTasks(););
 
-                        categorizeFileByContent(file, txtComparingContentOfFiles, acb, singleThread); //throw ThreadInterruption
+                        categorizeFileByContent(file, txtComparingContentOfFiles, acb, singleThread, hashCacheL, hashCacheR); //throw ThreadInterruption
                     });
 
                     bwl.filesToCompareBytewise.pop_front();
@@ -661,6 +847,18 @@ std::list<std::shared_ptr<BaseFolderPair>> ComparisonBuffer::compareByContent(co
         acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, cb_); //throw X
     }
 
+    //files not found during this comparison are dropped from the cache
+    for (const auto& [baseFolderPath, hashCache] : hashCaches)
+        if (hashCache.newHashes != hashCache.oldHashes) //don't touch the file if it isnt't strictly needed
+            try
+            {
+                saveContentHashCache(baseFolderPath, hashCache.newHashes); //throw FileError
+            }
+            catch (const FileError& e) //not an error in this context: e.g. read-only folder
+            {
+                cb_.reportInfo(e.toString()); //throw X
+            }
+
     return output;
 }
 
@@ -676,29 +874,116 @@ public:
         undefinedFiles_(undefinedFilesOut),
         undefinedSymlinks_(undefinedSymlinksOut) {}
 
-    void execute(const FolderContainer& lhs, const FolderContainer& rhs, ContainerObject& output)
-    {
-        auto it = errorsByRelPath_.find(Zstring()); //empty path if read-error for whole base directory
-
-        mergeTwoSides(lhs, rhs,
-                      it != errorsByRelPath_.end() ? &it->second : nullptr,
-                      output);
-    }
+    void execute(const FolderContainer& lhs, const FolderContainer& rhs, ContainerObject& output, size_t threadCount); //throw std::bad_alloc
 
 private:
+    using MergeSubtree = std::function<void(MergeSides& ms, const Zstringw* errorMsg)>;
+    struct ParallelMerge;
+
     void mergeTwoSides(const FolderContainer& lhs, const FolderContainer& rhs, const Zstringw* errorMsg, ContainerObject& output);
 
     template <SelectedSide side>
     void fillOneSide(const FolderContainer& folderCont, const Zstringw* errorMsg, ContainerObject& output);
 
+    template <class Function>
+    void recurse(bool haveSubFolders, const Zstringw* errorMsg, Function mergeSub);
+    void scheduleSubtree(const Zstringw* errorMsg, MergeSubtree&& mergeSub);
+
     const Zstringw* checkFailedRead(FileSystemObject& fsObj, const Zstringw* errorMsg);
 
     const std::map<ZstringNoCase, Zstringw>& errorsByRelPath_; //base-relative paths or empty if read-error for whole base directory
     std::vector<FilePair*>&    undefinedFiles_;
     std::vector<SymlinkPair*>& undefinedSymlinks_;
+    ParallelMerge* parallel_ = nullptr; //nullptr: merge all subtrees on the current thread
+};
+
+
+//subtrees are merged by a work-sharing thread pool: a worker hands off sub folders while other workers are idle
+//=> ContainerObject is modified by a single thread only; FileSystemObject::notifySyncCfgChanged() is read-only for shared parent folders
+struct MergeSides::ParallelMerge
+{
+    explicit ParallelMerge(size_t threadCountIn) : threadCount(threadCountIn), threadGroup(threadCountIn, "Merge Sides") {}
+
+    const size_t threadCount;
+    std::atomic<size_t> tasksQueued{0};
+
+    std::mutex lockResults;
+    std::deque<std::pair<std::vector<FilePair*>, std::vector<SymlinkPair*>>> results; //per task: undefined files and symlinks; std::deque: no reference invalidation!
+    std::exception_ptr firstError;
+
+    ThreadGroup<std::function<void()>> threadGroup; //declare last: join worker threads before shared state is destroyed!
 };
 
 
+void MergeSides::execute(const FolderContainer& lhs, const FolderContainer& rhs, ContainerObject& output, size_t threadCount) //throw std::bad_alloc
+{
+    auto it = errorsByRelPath_.find(Zstring()); //empty path if read-error for whole base directory
+    const Zstringw* errorMsg = it != errorsByRelPath_.end() ? &it->second : nullptr;
+
+    if (threadCount <= 1)
+        return mergeTwoSides(lhs, rhs, errorMsg, output);
+
+    ParallelMerge par(threadCount);
+    parallel_ = &par;
+    ZEN_ON_SCOPE_EXIT(parallel_ = nullptr);
+
+    scheduleSubtree(errorMsg, [&lhs, &rhs, &output](MergeSides& ms, const Zstringw* errorMsgSub) { ms.mergeTwoSides(lhs, rhs, errorMsgSub, output); });
+    par.threadGroup.wait();
+
+    if (par.firstError)
+        std::rethrow_exception(par.firstError); //throw std::bad_alloc
+
+    for (auto& [files, symlinks] : par.results)
+    {
+        append(undefinedFiles_,    files);
+        append(undefinedSymlinks_, symlinks);
+    }
+}
+
+
+template <class Function> inline
+void MergeSides::recurse(bool haveSubFolders, const Zstringw* errorMsg, Function mergeSub)
+{
+    //hand off only non-trivial subtrees: leaf folders are cheaper to merge than to schedule
+    if (parallel_ && haveSubFolders && parallel_->tasksQueued < parallel_->threadCount)
+        scheduleSubtree(errorMsg, std::move(mergeSub));
+    else
+        mergeSub(*this, errorMsg);
+}
+
+
+void MergeSides::scheduleSubtree(const Zstringw* errorMsg, MergeSubtree&& mergeSub)
+{
+    ParallelMerge& par = *parallel_;
+
+    std::pair<std::vector<FilePair*>, std::vector<SymlinkPair*>>* result = nullptr;
+    {
+        std::lock_guard dummy(par.lockResults);
+        result = &par.results.emplace_back();
+    }
+    ++par.tasksQueued;
+
+    //errorMsg may be a temporary (e.g. conflict message for ambiguous item name) => copy: Zstringw is ref-counted
+    par.threadGroup.run([&par, &errorsByRelPath = errorsByRelPath_, result, mergeSub = std::move(mergeSub),
+                                 errorMsgBuf = errorMsg ? std::optional<Zstringw>(*errorMsg) : std::nullopt]
+    {
+        --par.tasksQueued;
+        try
+        {
+            MergeSides ms(errorsByRelPath, result->first, result->second);
+            ms.parallel_ = &par;
+            mergeSub(ms, errorMsgBuf ? &*errorMsgBuf : nullptr);
+        }
+        catch (...) //std::bad_alloc
+        {
+            std::lock_guard dummy(par.lockResults);
+            if (!par.firstError)
+                par.firstError = std::current_exception();
+        }
+    });
+}
+
+
 inline
 const Zstringw* MergeSides::checkFailedRead(FileSystemObject& fsObj, const Zstringw* errorMsg)
 {
@@ -738,7 +1023,9 @@ void MergeSides::fillOneSide(const FolderContainer& folderCont, const Zstringw*
     {
         FolderPair& newFolder = output.addSubFolder<side>(folderName, attrAndSub.first);
         const Zstringw* errorMsgNew = checkFailedRead(newFolder, errorMsg);
-        fillOneSide<side>(attrAndSub.second, errorMsgNew, newFolder); //recurse
+
+        recurse(!attrAndSub.second.folders.empty(), errorMsgNew, [sub = &attrAndSub.second, folder = &newFolder](MergeSides& ms, const Zstringw* errorMsgSub)
+        { ms.fillOneSide<side>(*sub, errorMsgSub, *folder); });
     }
 }
 
@@ -746,71 +1033,165 @@ void MergeSides::fillOneSide(const FolderContainer& folderCont, const Zstringw*
 template <class MapType, class ProcessLeftOnly, class ProcessRightOnly, class ProcessBoth> inline
 void matchFolders(const MapType& mapLeft, const MapType& mapRight, ProcessLeftOnly lo, ProcessRightOnly ro, ProcessBoth bo)
 {
+    constexpr size_t NO_ITEM = static_cast<size_t>(-1);
+
     struct FileRef
     {
-        Zstring upperCaseName; //buffer expensive makeUpperCopy() calls!!
         const typename MapType::value_type* ref;
         bool leftSide;
+
+        //match key: upper-case name, ignore Unicode normalization
+        Zstring upperCaseName; //non-ASCII names only: buffer expensive makeUpperCopy() calls!!
+        const Zchar* keyStr;   //ASCII: points to raw name => no allocation, upper-case on the fly
+        size_t keyLen;
+        bool foldAscii;
+        size_t keyHash;
+
+        size_t nextInGroup; //index into fileList
     };
     std::vector<FileRef> fileList;
-    fileList.reserve(mapLeft.size() + mapRight.size()); //perf: ~5% shorter runtime
+    fileList.reserve(mapLeft.size() + mapRight.size()); //[!] no reallocation: FileRef::keyStr
+
+    auto getKeyChar = [](const FileRef& fr, size_t pos) { return fr.foldAscii ? asciiToUpper(fr.keyStr[pos]) : fr.keyStr[pos]; };
+
+    auto addItem = [&](const typename MapType::value_type& item, bool leftSide)
+    {
+        FileRef& fr = fileList.emplace_back();
+        fr.ref      = &item;
+        fr.leftSide = leftSide;
+
+        if (isAsciiString(item.first.c_str(), item.first.size())) //perf: no upper-case copy
+        {
+            fr.keyStr    = item.first.c_str();
+            fr.keyLen    = item.first.size();
+            fr.foldAscii = true;
+        }
+        else
+        {
+            fr.upperCaseName = makeUpperCopy(item.first);
+            fr.keyStr    = fr.upperCaseName.c_str();
+            fr.keyLen    = fr.upperCaseName.size();
+            fr.foldAscii = false;
+        }
+
+        size_t hash = 14695981039346656037ULL; //FNV-1a
+        for (size_t i = 0; i < fr.keyLen; ++i)
+        {
+            hash ^= static_cast<unsigned char>(getKeyChar(fr, i));
+            hash *= 1099511628211ULL;
+        }
+        fr.keyHash     = hash;
+        fr.nextInGroup = NO_ITEM;
+    };
+    for (const auto& item : mapLeft ) addItem(item, true);
+    for (const auto& item : mapRight) addItem(item, false);
+
+    auto equalKey = [&](const FileRef& lhs, const FileRef& rhs)
+    {
+        if (lhs.keyHash != rhs.keyHash || lhs.keyLen != rhs.keyLen)
+            return false;
+        for (size_t i = 0; i < lhs.keyLen; ++i)
+            if (getKeyChar(lhs, i) != getKeyChar(rhs, i))
+                return false;
+        return true;
+    };
+
+    auto lessKey = [&](const FileRef& lhs, const FileRef& rhs) //same order as "upperCaseName <"
+    {
+        const size_t len = std::min(lhs.keyLen, rhs.keyLen);
+        for (size_t i = 0; i < len; ++i)
+        {
+            const Zchar charL = getKeyChar(lhs, i);
+            const Zchar charR = getKeyChar(rhs, i);
+            if (charL != charR)
+                return charL < charR;
+        }
+        return lhs.keyLen < rhs.keyLen;
+    };
+
+    //hash join: group items with equal key (open addressing, linear probing)
+    std::vector<size_t> groupHeads; //index into fileList
+    {
+        size_t bucketCount = 16;
+        while (bucketCount < 2 * fileList.size())
+            bucketCount *= 2;
+        std::vector<size_t> buckets(bucketCount, NO_ITEM);
 
-    for (const auto& item : mapLeft ) fileList.push_back({ makeUpperCopy(item.first), &item, true });
-    for (const auto& item : mapRight) fileList.push_back({ makeUpperCopy(item.first), &item, false });
+        for (size_t idx = 0; idx < fileList.size(); ++idx)
+            for (size_t pos = fileList[idx].keyHash & (bucketCount - 1);; pos = (pos + 1) & (bucketCount - 1))
+            {
+                const size_t headIdx = buckets[pos];
+                if (headIdx == NO_ITEM)
+                {
+                    buckets[pos] = idx;
+                    groupHeads.push_back(idx);
+                    break;
+                }
+                if (equalKey(fileList[headIdx], fileList[idx]))
+                {
+                    fileList[idx    ].nextInGroup = fileList[headIdx].nextInGroup;
+                    fileList[headIdx].nextInGroup = idx;
+                    break;
+                }
+            }
+    }
 
-    //primary sort: ignore unicode normal form and case
+    //sort groups instead of items: ignore unicode normal form and case
     //bonus: natural default sequence on file guid UI
-    std::sort(fileList.begin(), fileList.end(), [](const FileRef& lhs, const FileRef& rhs) { return lhs.upperCaseName < rhs.upperCaseName; });
+    std::sort(groupHeads.begin(), groupHeads.end(), [&](size_t lhs, size_t rhs) { return lessKey(fileList[lhs], fileList[rhs]); });
 
     auto tryMatchRange = [&](auto it, auto itLast)
     {
-        const size_t equalCountL = std::count_if(it, itLast, [](const FileRef& fr) { return fr.leftSide; });
+        const size_t equalCountL = std::count_if(it, itLast, [](const FileRef* fr) { return fr->leftSide; });
         const size_t equalCountR = itLast - it - equalCountL;
 
         if (equalCountL == 1 && equalCountR == 1) //we have a match
         {
-            if (it->leftSide)
-                bo(*it[0].ref, *it[1].ref);
+            if (it[0]->leftSide)
+                bo(*it[0]->ref, *it[1]->ref);
             else
-                bo(*it[1].ref, *it[0].ref);
+                bo(*it[1]->ref, *it[0]->ref);
         }
         else if (equalCountL == 1 && equalCountR == 0)
-            lo(*it->ref, nullptr);
+            lo(*it[0]->ref, nullptr);
         else if (equalCountL == 0 && equalCountR == 1)
-            ro(*it->ref, nullptr);
+            ro(*it[0]->ref, nullptr);
         else //ambiguous (yes, even if one side only, e.g. different Unicode normalization forms)
             return false;
         return true;
     };
 
-    for (auto it = fileList.begin(); it != fileList.end();)
+    std::vector<const FileRef*> groupItems;
+    for (const size_t headIdx : groupHeads)
     {
-        //find equal range: ignore case, ignore Unicode normalization
-        auto itEndEq = std::find_if(it + 1, fileList.end(), [&](const FileRef& fr) { return fr.upperCaseName != it->upperCaseName; });
-        if (!tryMatchRange(it, itEndEq))
+        groupItems.clear();
+        for (size_t idx = headIdx; idx != NO_ITEM; idx = fileList[idx].nextInGroup)
+            groupItems.push_back(&fileList[idx]);
+
+        //equal range: ignore case, ignore Unicode normalization
+        if (!tryMatchRange(groupItems.begin(), groupItems.end()))
         {
             //secondary sort: respect case, ignore unicode normal forms
-            std::sort(it, itEndEq, [](const FileRef& lhs, const FileRef& rhs) { return getUnicodeNormalForm(lhs.ref->first) < getUnicodeNormalForm(rhs.ref->first); });
+            std::sort(groupItems.begin(), groupItems.end(), [](const FileRef* lhs, const FileRef* rhs) { return getUnicodeNormalForm(lhs->ref->first) < getUnicodeNormalForm(rhs->ref->first); });
 
-            for (auto itCase = it; itCase != itEndEq;)
+            for (auto itCase = groupItems.begin(); itCase != groupItems.end();)
             {
                 //find equal range: respect case, ignore Unicode normalization
-                auto itEndCase = std::find_if(itCase + 1, itEndEq, [&](const FileRef& fr) { return getUnicodeNormalForm(fr.ref->first) != getUnicodeNormalForm(itCase->ref->first); });
+                auto itEndCase = std::find_if(itCase + 1, groupItems.end(), [&](const FileRef* fr) { return getUnicodeNormalForm(fr->ref->first) != getUnicodeNormalForm((*itCase)->ref->first); });
                 if (!tryMatchRange(itCase, itEndCase))
                 {
-                    const Zstringw& conflictMsg = getConflictAmbiguousItemName(itCase->ref->first);
-                    std::for_each(itCase, itEndCase, [&](const FileRef& fr)
+                    const Zstringw& conflictMsg = getConflictAmbiguousItemName((*itCase)->ref->first);
+                    std::for_each(itCase, itEndCase, [&](const FileRef* fr)
                     {
-                        if (fr.leftSide)
-                            lo(*fr.ref, &conflictMsg);
+                        if (fr->leftSide)
+                            lo(*fr->ref, &conflictMsg);
                         else
-                            ro(*fr.ref, &conflictMsg);
+                            ro(*fr->ref, &conflictMsg);
                     });
                 }
                 itCase = itEndCase;
             }
         }
-        it = itEndEq;
     }
 }
 
@@ -838,7 +1219,7 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
                                               fileRight.second);
         if (!checkFailedRead(newItem, errorMsg))
             undefinedFiles_.push_back(&newItem);
-        static_assert(std::is_same_v<ContainerObject::FileList, std::list<FilePair>>); //ContainerObject::addSubFile() must NOT invalidate references used in "undefinedFiles"!
+        static_assert(std::is_same_v<ContainerObject::FileList, std::list<FilePair, ContainerObject::FileList::allocator_type>>); //ContainerObject::addSubFile() must NOT invalidate references used in "undefinedFiles"!
     });
 
     //-----------------------------------------------------------------------------------------------
@@ -872,13 +1253,17 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
     {
         FolderPair& newFolder = output.addSubFolder<LEFT_SIDE>(dirLeft.first, dirLeft.second.first);
         const Zstringw* errorMsgNew = checkFailedRead(newFolder, conflictMsg ? conflictMsg : errorMsg);
-        this->fillOneSide<LEFT_SIDE>(dirLeft.second.second, errorMsgNew, newFolder); //recurse
+
+        this->recurse(!dirLeft.second.second.folders.empty(), errorMsgNew, [sub = &dirLeft.second.second, folder = &newFolder](MergeSides& ms, const Zstringw* errorMsgSub)
+        { ms.fillOneSide<LEFT_SIDE>(*sub, errorMsgSub, *folder); });
     },
     [&](const FolderData& dirRight, const Zstringw* conflictMsg)
     {
         FolderPair& newFolder = output.addSubFolder<RIGHT_SIDE>(dirRight.first, dirRight.second.first);
         const Zstringw* errorMsgNew = checkFailedRead(newFolder, conflictMsg ? conflictMsg : errorMsg);
-        this->fillOneSide<RIGHT_SIDE>(dirRight.second.second, errorMsgNew, newFolder); //recurse
+
+        this->recurse(!dirRight.second.second.folders.empty(), errorMsgNew, [sub = &dirRight.second.second, folder = &newFolder](MergeSides& ms, const Zstringw* errorMsgSub)
+        { ms.fillOneSide<RIGHT_SIDE>(*sub, errorMsgSub, *folder); });
     },
     [&](const FolderData& dirLeft, const FolderData& dirRight)
     {
@@ -890,7 +1275,9 @@ void MergeSides::mergeTwoSides(const FolderContainer& lhs, const FolderContainer
                 getUnicodeNormalForm(dirRight.first))
                 newFolder.setCategoryDiffMetadata(getDescrDiffMetaShortnameCase(newFolder));
 
-        mergeTwoSides(dirLeft.second.second, dirRight.second.second, errorMsgNew, newFolder); //recurse
+        this->recurse(!dirLeft.second.second.folders.empty() || !dirRight.second.second.folders.empty(), errorMsgNew,
+                      [subL = &dirLeft.second.second, subR = &dirRight.second.second, folder = &newFolder](MergeSides& ms, const Zstringw* errorMsgSub)
+        { ms.mergeTwoSides(*subL, *subR, errorMsgSub, *folder); });
     });
 }
 
@@ -905,7 +1292,7 @@ void stripExcludedDirectories(ContainerObject& hierObj, const PathFilter& filter
     //remove superfluous directories:
     //   this does not invalidate "std::vector<FilePair*>& undefinedFiles", since we delete folders only
     //   and there is no side-effect for memory positions of FilePair and SymlinkPair thanks to std::list!
-    static_assert(std::is_same_v<std::list<FolderPair>, ContainerObject::FolderList>);
+    static_assert(std::is_same_v<std::list<FolderPair, ContainerObject::FolderList::allocator_type>, ContainerObject::FolderList>);
 
     hierObj.refSubFolders().remove_if([&](FolderPair& folder)
     {
@@ -979,11 +1366,13 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const Resolv
                                                                               fileTimeTolerance_,
                                                                               fpCfg.ignoreTimeShiftMinutes);
 
-    //PERF_START;
+    StopWatch mergeTime;
     FolderContainer emptyFolderCont; //WTF!!! => using a temporary in the ternary conditional would implicitly call the FolderContainer copy-constructor!!!!!!
     MergeSides(failedReads, undefinedFiles, undefinedSymlinks).execute(bufValueLeft  ? bufValueLeft ->folderCont : emptyFolderCont,
-                                                                       bufValueRight ? bufValueRight->folderCont : emptyFolderCont, *output);
-    //PERF_STOP;
+                                                                       bufValueRight ? bufValueRight->folderCont : emptyFolderCont, *output, getCmpThreadCount()); //throw std::bad_alloc
+    logPhaseTime(_("Merge results"), mergeTime, cb_);
+
+    StopWatch filterTime;
 
     //##################### in/exclude rows according to filtering #####################
     //NOTE: we need to finish de-activating rows BEFORE binary comparison is run so that it can skip them!
@@ -995,6 +1384,7 @@ std::shared_ptr<BaseFolderPair> ComparisonBuffer::performComparison(const Resolv
     //apply soft filtering (hard filter already applied during traversal!)
     addSoftFiltering(*output, fpCfg.filter.timeSizeFilter);
 
+    logPhaseTime(_("Apply filter"), filterTime, cb_);
     //##################################################################################
     return output;
 }
@@ -1015,9 +1405,20 @@ void fff::logNonDefaultSettings(const XmlGlobalSettings& activeSettings, Process
     if (activeSettings.copyFilePermissions != defaultSettings.copyFilePermissions)
         changedSettingsMsg += L"\n    " + _("Copy file access permissions") + L" - " + (activeSettings.copyFilePermissions ? _("Enabled") : _("Disabled"));
 
+    if (activeSettings.stripedCopyMinSizeMB != defaultSettings.stripedCopyMinSizeMB)
+        changedSettingsMsg += L"\n    " + _("Striped file copy") + L" - " + numberTo<std::wstring>(activeSettings.stripedCopyMinSizeMB) + L" MB";
+
+    if (activeSettings.streamingIO != defaultSettings.streamingIO)
+        changedSettingsMsg += L"\n    " + _("Streaming I/O") + L" - " + numberTo<std::wstring>(activeSettings.streamingIO.blockSize / 1024) + L" KB" +
+                              (activeSettings.streamingIO.dropPageCache ? L", POSIX_FADV_DONTNEED" : L"") +
+                              (activeSettings.streamingIO.directIO      ? L", O_DIRECT"            : L"");
+
     if (activeSettings.fileTimeTolerance != defaultSettings.fileTimeTolerance)
         changedSettingsMsg += L"\n    " + _("File time tolerance") + L" - " + numberTo<std::wstring>(activeSettings.fileTimeTolerance);
 
+    if (activeSettings.cacheContentHashes != defaultSettings.cacheContentHashes)
+        changedSettingsMsg += L"\n    " + _("Cache content hashes") + L" - " + (activeSettings.cacheContentHashes ? _("Enabled") : _("Disabled"));
+
     if (activeSettings.runWithBackgroundPriority != defaultSettings.runWithBackgroundPriority)
         changedSettingsMsg += L"\n    " + _("Run with background priority") + L" - " + (activeSettings.runWithBackgroundPriority ? _("Enabled") : _("Disabled"));
 
@@ -1034,6 +1435,7 @@ void fff::logNonDefaultSettings(const XmlGlobalSettings& activeSettings, Process
 
 FolderComparison fff::compare(WarningDialogs& warnings,
                               int fileTimeTolerance,
+                              bool cacheContentHashes,
                               bool allowUserInteraction,
                               bool runWithBackgroundPriority,
                               bool createDirLocks,
@@ -1157,7 +1559,7 @@ FolderComparison fff::compare(WarningDialogs& warnings,
         {
             //------------ traverse/read folders -----------------------------------------------------
             //PERF_START;
-            ComparisonBuffer cmpBuff(foldersToRead, deviceParallelOps, fileTimeTolerance, callback);
+            ComparisonBuffer cmpBuff(foldersToRead, deviceParallelOps, fileTimeTolerance, cacheContentHashes, callback);
             //PERF_STOP;
 
             //process binary comparison as one junk
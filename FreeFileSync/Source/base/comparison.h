@@ -53,6 +53,7 @@ void logNonDefaultSettings(const XmlGlobalSettings& currentSettings, ProcessCall
 //FFS core routine:
 FolderComparison compare(WarningDialogs& warnings,
                          int fileTimeTolerance,
+                         bool cacheContentHashes, //compare by content: skip reading files unchanged since last hashed
                          bool allowUserInteraction,
                          bool runWithBackgroundPriority,
                          bool createDirLocks,
@@ -20,6 +20,8 @@ namespace
 const char FILE_FORMAT_DESCR[] = "FreeFileSync";
 const int DB_FORMAT_CONTAINER = 10; //since 2017-02-01
 const int DB_FORMAT_STREAM    =  3; //
+const int DB_FORMAT_JOURNAL   =  1; //since 2026-10-16
+const int DB_JOURNAL_COMPACT_PERCENT = 25; //merge journal into a new snapshot when exceeding this percentage of the snapshot size
 //-------------------------------------------------------------------------------------------------------------------------------
 
 struct SessionData
@@ -31,6 +33,7 @@ bool operator==(const SessionData& lhs, const SessionData& rhs) { return lhs.isL
 
 using UniqueId  = std::string;
 using DbStreams = std::map<UniqueId, SessionData>; //list of streams ordered by session UUID
+using DbJournal = std::map<UniqueId, std::vector<ByteArray>>; //session UUID => journal records (oldest first) to apply on top of the session's stream
 
 /*------------------------------------------------------------------------------
   | ensure 32/64 bit portability: use fixed size data types only e.g. uint32_t |
@@ -56,6 +59,14 @@ AbstractPath getDatabaseFilePath(const BaseFolderPair& baseFolder, bool tempfile
     return AFS::appendRelPath(baseFolder.getAbstractPath<side>(), dbFileName);
 }
 
+
+template <SelectedSide side> inline
+AbstractPath getJournalFilePath(const BaseFolderPair& baseFolder)
+{
+    //keep ".ffs_db" ending: excluded from comparison and ignored by RealTimeSync just like the database file
+    return AFS::appendRelPath(baseFolder.getAbstractPath<side>(), Zstring(Zstr(".sync.log")) + SYNC_DB_FILE_ENDING);
+}
+
 //#######################################################################################################################################
 
 void saveStreams(const DbStreams& streamList, const AbstractPath& dbPath, const IOCallback& notifyUnbufferedIO) //throw FileError
@@ -162,6 +173,95 @@ DbStreams loadStreams(const AbstractPath& dbPath, const IOCallback& notifyUnbuff
     }
 }
 
+
+void saveJournal(const DbJournal& journal, const AbstractPath& journalPath, const IOCallback& notifyUnbufferedIO) //throw FileError
+{
+    const std::unique_ptr<AFS::OutputStream> fileStreamOut = AFS::getOutputStream(journalPath, //throw FileError
+                                                                                  std::nullopt /*streamSize*/,
+                                                                                  std::nullopt /*modTime*/,
+                                                                                  notifyUnbufferedIO /*throw X*/);
+    writeArray(*fileStreamOut, FILE_FORMAT_DESCR, sizeof(FILE_FORMAT_DESCR)); //throw FileError, X
+    writeNumber<int32_t>(*fileStreamOut, DB_FORMAT_JOURNAL);                  //
+
+    writeNumber(*fileStreamOut, static_cast<uint32_t>(journal.size())); //throw FileError, X
+
+    for (const auto& [sessionID, records] : journal)
+    {
+        writeContainer<std::string>(*fileStreamOut, sessionID); //throw FileError, X
+
+        writeNumber(*fileStreamOut, static_cast<uint32_t>(records.size())); //throw FileError, X
+        for (const ByteArray& record : records)
+            writeContainer<ByteArray>(*fileStreamOut, record); //throw FileError, X
+    }
+
+    //commit and close stream:
+    fileStreamOut->finalize(); //throw FileError, X
+}
+
+
+DbJournal loadJournal(const AbstractPath& journalPath, const IOCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, X
+{
+    try
+    {
+        const std::unique_ptr<AFS::InputStream> fileStreamIn = AFS::getInputStream(journalPath, notifyUnbufferedIO); //throw FileError, ErrorFileLocked
+
+        //read FreeFileSync file identifier
+        char formatDescr[sizeof(FILE_FORMAT_DESCR)] = {};
+        readArray(*fileStreamIn, formatDescr, sizeof(formatDescr)); //throw FileError, ErrorFileLocked, X, UnexpectedEndOfStreamError
+
+        if (!std::equal(FILE_FORMAT_DESCR, FILE_FORMAT_DESCR + sizeof(FILE_FORMAT_DESCR), formatDescr) ||
+            readNumber<int32_t>(*fileStreamIn) != DB_FORMAT_JOURNAL) //throw FileError, ErrorFileLocked, X, UnexpectedEndOfStreamError
+            throw FileError(replaceCpy(_("Database file %x is incompatible."), L"%x", fmtPath(AFS::getDisplayPath(journalPath))));
+
+        DbJournal output;
+
+        size_t sessionCount = readNumber<uint32_t>(*fileStreamIn); //throw FileError, ErrorFileLocked, X, UnexpectedEndOfStreamError
+        while (sessionCount-- != 0)
+        {
+            std::vector<ByteArray>& records = output[readContainer<std::string>(*fileStreamIn)]; //throw FileError, ErrorFileLocked, X, UnexpectedEndOfStreamError
+
+            size_t recordCount = readNumber<uint32_t>(*fileStreamIn); //throw FileError, ErrorFileLocked, X, UnexpectedEndOfStreamError
+            while (recordCount-- != 0)
+                records.push_back(readContainer<ByteArray>(*fileStreamIn)); //throw FileError, ErrorFileLocked, X, UnexpectedEndOfStreamError
+        }
+        return output;
+    }
+    catch (FileError&)
+    {
+        bool journalNotYetExisting = false;
+        try { journalNotYetExisting = !AFS::itemStillExists(journalPath); /*throw FileError*/ }
+        catch (FileError&) {} //previous exception is more relevant
+
+        if (journalNotYetExisting) //no changes since last snapshot
+            return {};
+        throw;
+    }
+    catch (UnexpectedEndOfStreamError&)
+    {
+        throw FileError(_("Database file is corrupted:") + L"\n" + fmtPath(AFS::getDisplayPath(journalPath)), L"Unexpected end of stream.");
+    }
+    catch (const std::bad_alloc& e)
+    {
+        throw FileError(_("Database file is corrupted:") + L"\n" + fmtPath(AFS::getDisplayPath(journalPath)),
+                        _("Out of memory.") + L" " + utfTo<std::wstring>(e.what()));
+    }
+}
+
+
+//journals are updated one after the other => after a crash in between, only records found on both sides are valid
+std::vector<ByteArray> getCommonJournal(const DbJournal& journalLeft, const DbJournal& journalRight, const UniqueId& sessionID)
+{
+    auto itL = journalLeft .find(sessionID);
+    auto itR = journalRight.find(sessionID);
+    if (itL == journalLeft.end() || itR == journalRight.end())
+        return {};
+
+    std::vector<ByteArray> records;
+    for (size_t i = 0; i < itL->second.size() && i < itR->second.size() && itL->second[i] == itR->second[i]; ++i)
+        records.push_back(itL->second[i]);
+    return records;
+}
+
 //#######################################################################################################################################
 
 class StreamGenerator
@@ -239,7 +339,7 @@ private:
         writeNumber<uint32_t>(streamOutSmallNum_, static_cast<uint32_t>(container.files.size()));
         for (const auto& [itemName, inSyncData] : container.files)
         {
-            writeUtf8(streamOutText_, itemName);
+            writeUtf8(streamOutText_, itemName.orig);
             writeNumber(streamOutSmallNum_, static_cast<int32_t>(inSyncData.cmpVar));
             writeNumber<uint64_t>(streamOutSmallNum_, inSyncData.fileSize);
 
@@ -250,7 +350,7 @@ private:
         writeNumber<uint32_t>(streamOutSmallNum_, static_cast<uint32_t>(container.symlinks.size()));
         for (const auto& [itemName, inSyncData] : container.symlinks)
         {
-            writeUtf8(streamOutText_, itemName);
+            writeUtf8(streamOutText_, itemName.orig);
             writeNumber(streamOutSmallNum_, static_cast<int32_t>(inSyncData.cmpVar));
 
             writeLinkDescr(streamOutBigNum_, inSyncData.left);
@@ -260,7 +360,7 @@ private:
         writeNumber<uint32_t>(streamOutSmallNum_, static_cast<uint32_t>(container.folders.size()));
         for (const auto& [itemName, inSyncData] : container.folders)
         {
-            writeUtf8(streamOutText_, itemName);
+            writeUtf8(streamOutText_, itemName.orig);
             writeNumber<int32_t>(streamOutSmallNum_, inSyncData.status);
 
             recurse(inSyncData);
@@ -531,6 +631,219 @@ private:
 
 //#######################################################################################################################################
 
+/* Journal record: changes of the in-sync state since the previous record (or the session's stream)
+
+    folder delta: file updates (name, data) | file removals (name) | symlink updates | symlink removals | folder removals | folder updates (name, status, folder delta)
+
+  - only absolute values are stored => replaying a record more than once yields the same result
+  - item data is stored relative to the session's lead stream, like the stream itself                                            */
+
+//changes applied by LastSynchronousStateUpdater: no need to keep a copy of the old in-sync state for creating the journal record
+struct InSyncFolderChanges
+{
+    std::vector<InSyncFolder::FileList   ::const_iterator> fileUpdates; //items are not removed after being updated => iterators stay valid
+    std::vector<InSyncFolder::SymlinkList::const_iterator> linkUpdates; //
+    std::vector<Zstring> fileRemovals;
+    std::vector<Zstring> linkRemovals;
+    std::vector<Zstring> folderRemovals;
+    std::map<ZstringNorm, InSyncFolderChanges> folderUpdates;
+
+    bool statusChanged = false; //folder was created or has new status
+
+    bool empty() const
+    {
+        return !statusChanged &&
+               fileUpdates.empty() && fileRemovals.empty() &&
+               linkUpdates.empty() && linkRemovals.empty() &&
+               folderRemovals.empty() && folderUpdates.empty();
+    }
+};
+
+
+class JournalRecordGenerator
+{
+public:
+    static ByteArray execute(const InSyncFolder& dbFolder, //throw FileError; return empty if there are no changes
+                             const InSyncFolderChanges& changes,
+                             bool leadStreamLeft,
+                             const std::wstring& displayFilePathL, //used for diagnostics only
+                             const std::wstring& displayFilePathR)
+    {
+        const ByteArray delta = JournalRecordGenerator(leadStreamLeft).recurse(dbFolder, changes);
+        if (delta.empty())
+            return {};
+        try
+        {
+            return compress(delta, 3); //throw ZlibInternalError; same level as stream
+        }
+        catch (ZlibInternalError&)
+        {
+            throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(displayFilePathL + L"/" + displayFilePathR)), L"zlib internal error");
+        }
+    }
+
+private:
+    explicit JournalRecordGenerator(bool leadStreamLeft) : leadStreamLeft_(leadStreamLeft) {}
+
+    ByteArray recurse(const InSyncFolder& dbFolder, const InSyncFolderChanges& changes) const //return empty if no child items changed
+    {
+        if (changes.fileUpdates.empty() && changes.fileRemovals.empty() &&
+            changes.linkUpdates.empty() && changes.linkRemovals.empty() &&
+            changes.folderRemovals.empty() && changes.folderUpdates.empty())
+            return {};
+
+        MemoryStreamOut<ByteArray> streamOut;
+
+        writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(changes.fileUpdates.size()));
+        for (const auto& it : changes.fileUpdates)
+        {
+            const InSyncFile& file = it->second;
+            const InSyncDescrFile& dataLead  = leadStreamLeft_ ? file.left  : file.right;
+            const InSyncDescrFile& dataOther = leadStreamLeft_ ? file.right : file.left;
+
+            writeUtf8(streamOut, it->first.orig);
+            writeNumber<int8_t  >(streamOut, static_cast<int8_t>(file.cmpVar));
+            writeNumber<uint64_t>(streamOut, file.fileSize);
+            writeNumber<int64_t >(streamOut, dataLead .modTime);
+            writeContainer       (streamOut, dataLead .fileId);
+            writeNumber<int64_t >(streamOut, dataOther.modTime);
+            writeContainer       (streamOut, dataOther.fileId);
+        }
+        writeNames(streamOut, changes.fileRemovals);
+
+        writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(changes.linkUpdates.size()));
+        for (const auto& it : changes.linkUpdates)
+        {
+            const InSyncSymlink& symlink = it->second;
+            writeUtf8(streamOut, it->first.orig);
+            writeNumber<int8_t >(streamOut, static_cast<int8_t>(symlink.cmpVar));
+            writeNumber<int64_t>(streamOut, (leadStreamLeft_ ? symlink.left  : symlink.right).modTime);
+            writeNumber<int64_t>(streamOut, (leadStreamLeft_ ? symlink.right : symlink.left ).modTime);
+        }
+        writeNames(streamOut, changes.linkRemovals);
+
+        writeNames(streamOut, changes.folderRemovals);
+
+        writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(changes.folderUpdates.size()));
+        for (const auto& [folderName, subChanges] : changes.folderUpdates)
+        {
+            auto it = dbFolder.folders.find(folderName);
+            assert(it != dbFolder.folders.end()); //updated folders are never removed afterwards
+
+            writeUtf8(streamOut, it->first.orig);
+            writeNumber<int8_t>(streamOut, static_cast<int8_t>(it->second.status));
+            writeContainer(streamOut, recurse(it->second, subChanges));
+        }
+        return streamOut.ref();
+    }
+
+    static void writeNames(MemoryStreamOut<ByteArray>& streamOut, const std::vector<Zstring>& itemNames)
+    {
+        writeNumber<uint32_t>(streamOut, static_cast<uint32_t>(itemNames.size()));
+        for (const Zstring& itemName : itemNames)
+            writeUtf8(streamOut, itemName);
+    }
+
+    static void writeUtf8(MemoryStreamOut<ByteArray>& streamOut, const Zstring& str) { writeContainer(streamOut, utfTo<Zbase<char>>(str)); }
+
+    const bool leadStreamLeft_;
+};
+
+
+class JournalRecordParser
+{
+public:
+    static void execute(const ByteArray& record, //throw FileError
+                        bool leadStreamLeft,
+                        InSyncFolder& dbFolder,
+                        const std::wstring& displayFilePathL, //used for diagnostics only
+                        const std::wstring& displayFilePathR)
+    {
+        try
+        {
+            JournalRecordParser(leadStreamLeft).recurse(decompress(record), dbFolder); //throw ZlibInternalError, UnexpectedEndOfStreamError
+        }
+        catch (ZlibInternalError&)
+        {
+            throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(displayFilePathL + L"/" + displayFilePathR)), L"Zlib internal error");
+        }
+        catch (UnexpectedEndOfStreamError&)
+        {
+            throw FileError(_("Database file is corrupted:") + L"\n" + fmtPath(displayFilePathL) + L"\n" + fmtPath(displayFilePathR), L"Unexpected end of stream.");
+        }
+    }
+
+private:
+    explicit JournalRecordParser(bool leadStreamLeft) : leadStreamLeft_(leadStreamLeft) {}
+
+    void recurse(const ByteArray& delta, InSyncFolder& dbFolder) const //throw UnexpectedEndOfStreamError
+    {
+        if (delta.empty()) //no changes
+            return;
+
+        MemoryStreamIn<ByteArray> streamIn(delta);
+
+        size_t fileCount = readNumber<uint32_t>(streamIn); //throw UnexpectedEndOfStreamError
+        while (fileCount-- != 0)
+        {
+            const Zstring fileName = readUtf8(streamIn);
+            const auto cmpVar = static_cast<CompareVariant>(readNumber<int8_t>(streamIn));
+            const uint64_t fileSize = readNumber<uint64_t>(streamIn);
+            //attention: order of function argument evaluation is undefined! So do it one after the other...
+            const auto modTimeLead = readNumber<int64_t>(streamIn);
+            const AFS::FileId fileIdLead = readContainer<Zbase<char>>(streamIn);
+            const auto modTimeOther = readNumber<int64_t>(streamIn);
+            const AFS::FileId fileIdOther = readContainer<Zbase<char>>(streamIn);
+
+            const InSyncDescrFile dataLead (modTimeLead,  fileIdLead);
+            const InSyncDescrFile dataOther(modTimeOther, fileIdOther);
+
+            dbFolder.files.insert_or_assign(fileName, InSyncFile(leadStreamLeft_ ? dataLead : dataOther,
+                                                                 leadStreamLeft_ ? dataOther : dataLead, cmpVar, fileSize));
+        }
+        size_t fileRemovalCount = readNumber<uint32_t>(streamIn);
+        while (fileRemovalCount-- != 0)
+            dbFolder.files.erase(readUtf8(streamIn));
+
+        size_t linkCount = readNumber<uint32_t>(streamIn);
+        while (linkCount-- != 0)
+        {
+            const Zstring linkName = readUtf8(streamIn);
+            const auto cmpVar = static_cast<CompareVariant>(readNumber<int8_t>(streamIn));
+            const InSyncDescrLink dataLead (readNumber<int64_t>(streamIn));
+            const InSyncDescrLink dataOther(readNumber<int64_t>(streamIn));
+
+            dbFolder.symlinks.insert_or_assign(linkName, InSyncSymlink(leadStreamLeft_ ? dataLead : dataOther,
+                                                                       leadStreamLeft_ ? dataOther : dataLead, cmpVar));
+        }
+        size_t linkRemovalCount = readNumber<uint32_t>(streamIn);
+        while (linkRemovalCount-- != 0)
+            dbFolder.symlinks.erase(readUtf8(streamIn));
+
+        size_t folderRemovalCount = readNumber<uint32_t>(streamIn);
+        while (folderRemovalCount-- != 0)
+            dbFolder.folders.erase(readUtf8(streamIn));
+
+        size_t folderCount = readNumber<uint32_t>(streamIn);
+        while (folderCount-- != 0)
+        {
+            const Zstring folderName = readUtf8(streamIn);
+            const auto status = static_cast<InSyncFolder::InSyncStatus>(readNumber<int8_t>(streamIn));
+            const ByteArray subDelta = readContainer<ByteArray>(streamIn);
+
+            InSyncFolder& dbSubFolder = dbFolder.folders.emplace(folderName, InSyncFolder(status)).first->second; //get or create
+            dbSubFolder.status = status;
+            recurse(subDelta, dbSubFolder); //throw UnexpectedEndOfStreamError
+        }
+    }
+
+    static Zstring readUtf8(MemoryStreamIn<ByteArray>& streamIn) { return utfTo<Zstring>(readContainer<Zbase<char>>(streamIn)); } //throw UnexpectedEndOfStreamError
+
+    const bool leadStreamLeft_;
+};
+
+//#######################################################################################################################################
+
 class LastSynchronousStateUpdater
 {
     /*
@@ -540,10 +853,10 @@ class LastSynchronousStateUpdater
         => update all database entries!
     */
 public:
-    static void execute(const BaseFolderPair& baseFolder, InSyncFolder& dbFolder)
+    static void execute(const BaseFolderPair& baseFolder, InSyncFolder& dbFolder, InSyncFolderChanges& changes)
     {
         LastSynchronousStateUpdater updater(baseFolder.getCompVariant(), baseFolder.getFilter());
-        updater.recurse(baseFolder, dbFolder);
+        updater.recurse(baseFolder, dbFolder, changes);
     }
 
 private:
@@ -551,27 +864,43 @@ private:
         filter_(filter),
         activeCmpVar_(activeCmpVar) {}
 
-    void recurse(const ContainerObject& hierObj, InSyncFolder& dbFolder)
+    void recurse(const ContainerObject& hierObj, InSyncFolder& dbFolder, InSyncFolderChanges& changes)
     {
-        process(hierObj.refSubFiles  (), hierObj.getRelativePathAny(), dbFolder.files);
-        process(hierObj.refSubLinks  (), hierObj.getRelativePathAny(), dbFolder.symlinks);
-        process(hierObj.refSubFolders(), hierObj.getRelativePathAny(), dbFolder.folders);
+        process(hierObj.refSubFiles  (), hierObj.getRelativePathAny(), dbFolder.files,    changes);
+        process(hierObj.refSubLinks  (), hierObj.getRelativePathAny(), dbFolder.symlinks, changes);
+        process(hierObj.refSubFolders(), hierObj.getRelativePathAny(), dbFolder.folders,  changes);
     }
 
-    template <class M, class V>
-    static V& mapAddOrUpdate(M& map, const Zstring& key, V&& value)
+    //return valid iterator if item was added or changed
+    template <class M, class V, class IsEqual>
+    static std::optional<typename M::const_iterator> mapAddOrUpdate(M& map, const Zstring& key, V&& value, IsEqual isEqual)
     {
         //C++17's map::try_emplace() is faster than map::emplace() if key is already existing
         const auto [it, inserted] = map.try_emplace(key, std::forward<V>(value)); //and does NOT MOVE r-value arguments unlike map::emplace()!
         if (!inserted)
+        {
+            if (isEqual(it->second, value))
+                return {};
             it->second = std::forward<V>(value);
+        }
+        return it;
+    }
+
+    static bool isEqualFile(const InSyncFile& lhs, const InSyncFile& rhs)
+    {
+        return lhs.cmpVar == rhs.cmpVar && lhs.fileSize == rhs.fileSize &&
+               lhs.left .modTime == rhs.left .modTime && lhs.left .fileId == rhs.left .fileId &&
+               lhs.right.modTime == rhs.right.modTime && lhs.right.fileId == rhs.right.fileId;
+    }
 
-        return it->second;
+    static bool isEqualSymlink(const InSyncSymlink& lhs, const InSyncSymlink& rhs)
+    {
+        return lhs.cmpVar == rhs.cmpVar && lhs.left.modTime == rhs.left.modTime && lhs.right.modTime == rhs.right.modTime;
     }
 
-    void process(const ContainerObject::FileList& currentFiles, const Zstring& parentRelPath, InSyncFolder::FileList& dbFiles)
+    void process(const ContainerObject::FileList& currentFiles, const Zstring& parentRelPath, InSyncFolder::FileList& dbFiles, InSyncFolderChanges& changes)
     {
-        std::set<Zstring, LessUnicodeNormal> toPreserve;
+        std::set<ZstringNorm> toPreserve;
 
         for (const FilePair& file : currentFiles)
             if (!file.isPairEmpty())
@@ -585,13 +914,14 @@ private:
                     assert(file.getFileSize<LEFT_SIDE>() == file.getFileSize<RIGHT_SIDE>());
 
                     //create or update new "in-sync" state
-                    mapAddOrUpdate(dbFiles, file.getItemNameAny(),
-                                   InSyncFile(InSyncDescrFile(file.getLastWriteTime< LEFT_SIDE>(),
-                                                              file.getFileId       < LEFT_SIDE>()),
-                                              InSyncDescrFile(file.getLastWriteTime<RIGHT_SIDE>(),
-                                                              file.getFileId       <RIGHT_SIDE>()),
-                                              activeCmpVar_,
-                                              file.getFileSize<LEFT_SIDE>()));
+                    if (const auto itUpdated = mapAddOrUpdate(dbFiles, file.getItemNameAny(),
+                                                              InSyncFile(InSyncDescrFile(file.getLastWriteTime< LEFT_SIDE>(),
+                                                                                         file.getFileId       < LEFT_SIDE>()),
+                                                                         InSyncDescrFile(file.getLastWriteTime<RIGHT_SIDE>(),
+                                                                                         file.getFileId       <RIGHT_SIDE>()),
+                                                                         activeCmpVar_,
+                                                                         file.getFileSize<LEFT_SIDE>()), isEqualFile))
+                        changes.fileUpdates.push_back(*itUpdated);
                     toPreserve.insert(file.getItemNameAny());
                 }
                 else //not in sync: preserve last synchronous state
@@ -607,15 +937,18 @@ private:
             if (toPreserve.find(v.first) != toPreserve.end())
                 return false;
             //all items not existing in "currentFiles" have either been deleted meanwhile or been excluded via filter:
-            const Zstring& itemRelPath = nativeAppendPaths(parentRelPath, v.first);
-            return filter_.passFileFilter(itemRelPath);
+            const Zstring& itemRelPath = nativeAppendPaths(parentRelPath, v.first.orig);
+            if (!filter_.passFileFilter(itemRelPath))
+                return false;
             //note: items subject to traveral errors are also excluded by this file filter here! see comparison.cpp, modified file filter for read errors
+            changes.fileRemovals.push_back(v.first.orig);
+            return true;
         });
     }
 
-    void process(const ContainerObject::SymlinkList& currentSymlinks, const Zstring& parentRelPath, InSyncFolder::SymlinkList& dbSymlinks)
+    void process(const ContainerObject::SymlinkList& currentSymlinks, const Zstring& parentRelPath, InSyncFolder::SymlinkList& dbSymlinks, InSyncFolderChanges& changes)
     {
-        std::set<Zstring, LessUnicodeNormal> toPreserve;
+        std::set<ZstringNorm> toPreserve;
 
         for (const SymlinkPair& symlink : currentSymlinks)
             if (!symlink.isPairEmpty())
@@ -625,10 +958,11 @@ private:
                     assert(getUnicodeNormalForm(symlink.getItemName<LEFT_SIDE>()) == getUnicodeNormalForm(symlink.getItemName<RIGHT_SIDE>()));
 
                     //create or update new "in-sync" state
-                    mapAddOrUpdate(dbSymlinks, symlink.getItemNameAny(),
-                                   InSyncSymlink(InSyncDescrLink(symlink.getLastWriteTime< LEFT_SIDE>()),
-                                                 InSyncDescrLink(symlink.getLastWriteTime<RIGHT_SIDE>()),
-                                                 activeCmpVar_));
+                    if (const auto itUpdated = mapAddOrUpdate(dbSymlinks, symlink.getItemNameAny(),
+                                                              InSyncSymlink(InSyncDescrLink(symlink.getLastWriteTime< LEFT_SIDE>()),
+                                                                            InSyncDescrLink(symlink.getLastWriteTime<RIGHT_SIDE>()),
+                                                                            activeCmpVar_), isEqualSymlink))
+                        changes.linkUpdates.push_back(*itUpdated);
                     toPreserve.insert(symlink.getItemNameAny());
                 }
                 else //not in sync: preserve last synchronous state
@@ -644,12 +978,25 @@ private:
             if (toPreserve.find(v.first) != toPreserve.end())
                 return false;
             //all items not existing in "currentSymlinks" have either been deleted meanwhile or been excluded via filter:
-            const Zstring& itemRelPath = nativeAppendPaths(parentRelPath, v.first);
-            return filter_.passFileFilter(itemRelPath);
+            const Zstring& itemRelPath = nativeAppendPaths(parentRelPath, v.first.orig);
+            if (!filter_.passFileFilter(itemRelPath))
+                return false;
+            changes.linkRemovals.push_back(v.first.orig);
+            return true;
         });
     }
 
-    void process(const ContainerObject::FolderList& currentFolders, const Zstring& parentRelPath, InSyncFolder::FolderList& dbFolders)
+    //record changes of a sub folder only if there are any
+    template <class Function>
+    static void trackFolderChanges(const ZstringNorm& folderName, InSyncFolderChanges& changes, Function updateFolder)
+    {
+        InSyncFolderChanges& subChanges = changes.folderUpdates[folderName];
+        updateFolder(subChanges);
+        if (subChanges.empty())
+            changes.folderUpdates.erase(folderName);
+    }
+
+    void process(const ContainerObject::FolderList& currentFolders, const Zstring& parentRelPath, InSyncFolder::FolderList& dbFolders, InSyncFolderChanges& changes)
     {
         std::unordered_set<const InSyncFolder*> toPreserve;
 
@@ -661,11 +1008,18 @@ private:
                     assert(getUnicodeNormalForm(folder.getItemName<LEFT_SIDE>()) == getUnicodeNormalForm(folder.getItemName<RIGHT_SIDE>()));
 
                     //update directory entry only (shallow), but do *not touch* exising child elements!!!
-                    InSyncFolder& dbFolder = dbFolders.emplace(folder.getItemNameAny(), InSyncFolder(InSyncFolder::DIR_STATUS_IN_SYNC)).first->second; //get or create
-                    dbFolder.status = InSyncFolder::DIR_STATUS_IN_SYNC; //update immediate directory entry
+                    const auto [it, inserted] = dbFolders.emplace(folder.getItemNameAny(), InSyncFolder(InSyncFolder::DIR_STATUS_IN_SYNC)); //get or create
+                    InSyncFolder& dbFolder = it->second;
 
+                    trackFolderChanges(it->first, changes, [&](InSyncFolderChanges& subChanges)
+                    {
+                        if (inserted || dbFolder.status != InSyncFolder::DIR_STATUS_IN_SYNC)
+                            subChanges.statusChanged = true;
+                        dbFolder.status = InSyncFolder::DIR_STATUS_IN_SYNC; //update immediate directory entry
+
+                        recurse(folder, dbFolder, subChanges);
+                    });
                     toPreserve.insert(&dbFolder);
-                    recurse(folder, dbFolder);
                 }
                 else //not in sync: preserve last synchronous state
                 {
@@ -675,7 +1029,10 @@ private:
                         if (it != dbFolders.end())
                         {
                             toPreserve.insert(&it->second);
-                            recurse(folder, it->second); //required: existing child-items may not be in sync, but items deleted on both sides *are* in-sync!!!
+                            trackFolderChanges(it->first, changes, [&](InSyncFolderChanges& subChanges)
+                            {
+                                recurse(folder, it->second, subChanges); //required: existing child-items may not be in sync, but items deleted on both sides *are* in-sync!!!
+                            });
                         }
                     };
                     preserveDbEntry(folder.getItemName<LEFT_SIDE>());
@@ -692,32 +1049,54 @@ private:
             if (toPreserve.find(&v.second) != toPreserve.end())
                 return false;
 
-            const Zstring& itemRelPath = nativeAppendPaths(parentRelPath, v.first);
+            const Zstring& itemRelPath = nativeAppendPaths(parentRelPath, v.first.orig);
             //if folder is not included in "current folders", it is either not existing anymore, in which case it should be deleted from database
             //or it was excluded via filter and the database entry should be preserved
 
             bool childItemMightMatch = true;
             const bool passFilter = filter_.passDirFilter(itemRelPath, &childItemMightMatch);
             if (!passFilter && childItemMightMatch)
-                dbSetEmptyState(v.second, appendSeparator(itemRelPath)); //child items might match, e.g. *.txt include filter!
+                trackFolderChanges(v.first, changes, [&](InSyncFolderChanges& subChanges)
+                {
+                    dbSetEmptyState(v.second, appendSeparator(itemRelPath), subChanges); //child items might match, e.g. *.txt include filter!
+                });
+            if (passFilter)
+                changes.folderRemovals.push_back(v.first.orig);
             return passFilter;
         });
     }
 
     //delete all entries for removed folder (= "in-sync") from database
-    void dbSetEmptyState(InSyncFolder& dbFolder, const Zstring& parentRelPathPf)
+    void dbSetEmptyState(InSyncFolder& dbFolder, const Zstring& parentRelPathPf, InSyncFolderChanges& changes)
     {
-        eraseIf(dbFolder.files,    [&](const InSyncFolder::FileList   ::value_type& v) { return filter_.passFileFilter(parentRelPathPf + v.first); });
-        eraseIf(dbFolder.symlinks, [&](const InSyncFolder::SymlinkList::value_type& v) { return filter_.passFileFilter(parentRelPathPf + v.first); });
+        eraseIf(dbFolder.files, [&](const InSyncFolder::FileList::value_type& v)
+        {
+            if (!filter_.passFileFilter(parentRelPathPf + v.first.orig))
+                return false;
+            changes.fileRemovals.push_back(v.first.orig);
+            return true;
+        });
+        eraseIf(dbFolder.symlinks, [&](const InSyncFolder::SymlinkList::value_type& v)
+        {
+            if (!filter_.passFileFilter(parentRelPathPf + v.first.orig))
+                return false;
+            changes.linkRemovals.push_back(v.first.orig);
+            return true;
+        });
 
         eraseIf(dbFolder.folders, [&](InSyncFolder::FolderList::value_type& v)
         {
-            const Zstring& itemRelPath = parentRelPathPf + v.first;
+            const Zstring& itemRelPath = parentRelPathPf + v.first.orig;
 
             bool childItemMightMatch = true;
             const bool passFilter = filter_.passDirFilter(itemRelPath, &childItemMightMatch);
             if (!passFilter && childItemMightMatch)
-                dbSetEmptyState(v.second, appendSeparator(itemRelPath));
+                trackFolderChanges(v.first, changes, [&](InSyncFolderChanges& subChanges)
+                {
+                    dbSetEmptyState(v.second, appendSeparator(itemRelPath), subChanges);
+                });
+            if (passFilter)
+                changes.folderRemovals.push_back(v.first.orig);
             return passFilter;
         });
     }
@@ -788,6 +1167,9 @@ std::shared_ptr<InSyncFolder> fff::loadLastSynchronousState(const BaseFolderPair
     const AbstractPath dbPathLeft  = getDatabaseFilePath< LEFT_SIDE>(baseFolder);
     const AbstractPath dbPathRight = getDatabaseFilePath<RIGHT_SIDE>(baseFolder);
 
+    const AbstractPath journalPathLeft  = getJournalFilePath< LEFT_SIDE>(baseFolder);
+    const AbstractPath journalPathRight = getJournalFilePath<RIGHT_SIDE>(baseFolder);
+
     if (!baseFolder.isAvailable< LEFT_SIDE>() ||
         !baseFolder.isAvailable<RIGHT_SIDE>())
     {
@@ -816,9 +1198,18 @@ std::shared_ptr<InSyncFolder> fff::loadLastSynchronousState(const BaseFolderPair
     const ByteArray& streamL = session.first ->second.rawStream;
     const ByteArray& streamR = session.second->second.rawStream;
 
-    return StreamParser::execute(leadStreamLeft, streamL, streamR, //throw FileError
-                                 AFS::getDisplayPath(dbPathLeft),
-                                 AFS::getDisplayPath(dbPathRight));
+    std::shared_ptr<InSyncFolder> lastSyncState = StreamParser::execute(leadStreamLeft, streamL, streamR, //throw FileError
+                                                                        AFS::getDisplayPath(dbPathLeft),
+                                                                        AFS::getDisplayPath(dbPathRight));
+    //replay changes made since the stream was written
+    const DbJournal journalLeft  = loadJournal(journalPathLeft,  notifyLoadL); //throw FileError, X
+    const DbJournal journalRight = loadJournal(journalPathRight, notifyLoadR); //
+
+    for (const ByteArray& record : getCommonJournal(journalLeft, journalRight, session.first->first))
+        JournalRecordParser::execute(record, leadStreamLeft, *lastSyncState, //throw FileError
+                                     AFS::getDisplayPath(dbPathLeft),
+                                     AFS::getDisplayPath(dbPathRight));
+    return lastSyncState;
 }
 
 
@@ -831,6 +1222,9 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, const std::
     const AbstractPath dbPathLeftTmp  = getDatabaseFilePath< LEFT_SIDE>(baseFolder, true /*tempfile*/);
     const AbstractPath dbPathRightTmp = getDatabaseFilePath<RIGHT_SIDE>(baseFolder, true /*tempfile*/);
 
+    const AbstractPath journalPathLeft  = getJournalFilePath< LEFT_SIDE>(baseFolder);
+    const AbstractPath journalPathRight = getJournalFilePath<RIGHT_SIDE>(baseFolder);
+
     StreamStatusNotifier notifyLoadL(replaceCpy(_("Loading file %x..."), L"%x", fmtPath(AFS::getDisplayPath(dbPathLeft) )), notifyStatus);
     StreamStatusNotifier notifyLoadR(replaceCpy(_("Loading file %x..."), L"%x", fmtPath(AFS::getDisplayPath(dbPathRight))), notifyStatus);
 
@@ -847,9 +1241,21 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, const std::
     catch (FileError&) {}
     //if error occurs: just overwrite old file! User is already informed about issues right after comparing!
 
+    DbJournal journalLeft;
+    DbJournal journalRight;
+    bool journalCorrupted = false;
+    try { journalLeft  = loadJournal(journalPathLeft, notifyLoadL); } //throw FileError, X
+    catch (FileError&) { journalCorrupted = true; }
+    try { journalRight = loadJournal(journalPathRight, notifyLoadR); } //throw FileError, X
+    catch (FileError&) { journalCorrupted = true; }
+    //if error occurs: discard journal and write a new snapshot
+
     auto lastSyncState = std::make_shared<InSyncFolder>(InSyncFolder::DIR_STATUS_IN_SYNC);
     auto itStreamOldL = streamsLeft .cend();
     auto itStreamOldR = streamsRight.cend();
+    bool leadStreamLeft = true;
+    std::vector<ByteArray> journalRecords;
+    bool appendToJournal = false; //changes since lastSyncState was loaded can be appended
     try
     {
         //find associated session: there can be at most one session within intersection of left and right ids
@@ -857,7 +1263,7 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, const std::
                                                                 AFS::getDisplayPath(dbPathLeft),
                                                                 AFS::getDisplayPath(dbPathRight));
 
-        const bool leadStreamLeft = itStreamOldL->second.isLeadStream;
+        leadStreamLeft = itStreamOldL->second.isLeadStream;
 
         //load last synchrounous state
         lastSyncState = StreamParser::execute(leadStreamLeft,
@@ -865,11 +1271,65 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, const std::
                                               itStreamOldR->second.rawStream,
                                               AFS::getDisplayPath(dbPathLeft),
                                               AFS::getDisplayPath(dbPathRight));
+
+        journalRecords = getCommonJournal(journalLeft, journalRight, itStreamOldL->first);
+        for (const ByteArray& record : journalRecords)
+            JournalRecordParser::execute(record, leadStreamLeft, *lastSyncState, //throw FileError
+                                         AFS::getDisplayPath(dbPathLeft),
+                                         AFS::getDisplayPath(dbPathRight));
+        appendToJournal = !journalCorrupted;
     }
     catch (FileError&) {} //if error occurs: just overwrite old file! User is already informed about issues right after comparing!
 
     //update last synchrounous state
-    LastSynchronousStateUpdater::execute(baseFolder, *lastSyncState);
+    InSyncFolderChanges changes;
+    LastSynchronousStateUpdater::execute(baseFolder, *lastSyncState, changes);
+
+    //journal records of sessions no longer existing are obsolete
+    auto removeObsoleteSessions = [](DbJournal& journal, const DbStreams& streams)
+    {
+        eraseIf(journal, [&](const DbJournal::value_type& v) { return streams.find(v.first) == streams.end(); });
+    };
+
+    //small changes: append to journal instead of rewriting the complete database
+    if (appendToJournal)
+    {
+        const ByteArray record = JournalRecordGenerator::execute(*lastSyncState, changes, leadStreamLeft, //throw FileError
+                                                                 AFS::getDisplayPath(dbPathLeft),
+                                                                 AFS::getDisplayPath(dbPathRight));
+        if (record.empty())
+            return; //some users monitor the *.ffs_db file with RTS => don't touch the file if it isnt't strictly needed
+
+        journalRecords.push_back(record);
+
+        size_t journalSize = 0;
+        for (const ByteArray& r : journalRecords)
+            journalSize += r.size();
+
+        if (journalSize * 100 <= (itStreamOldL->second.rawStream.size() + itStreamOldR->second.rawStream.size()) * DB_JOURNAL_COMPACT_PERCENT)
+        {
+            journalLeft [itStreamOldL->first] = journalRecords;
+            journalRight[itStreamOldR->first] = journalRecords;
+            removeObsoleteSessions(journalLeft,  streamsLeft);
+            removeObsoleteSessions(journalRight, streamsRight);
+
+            //write (temp-) files as a transaction
+            saveJournal(journalLeft,  dbPathLeftTmp,  notifySaveL); //throw FileError, X
+            auto guardTmpL = makeGuard<ScopeGuardRunMode::ON_FAIL>([&] { try { AFS::removeFilePlain(dbPathLeftTmp); } catch (FileError&) {} });
+            saveJournal(journalRight, dbPathRightTmp, notifySaveR); //
+            auto guardTmpR = makeGuard<ScopeGuardRunMode::ON_FAIL>([&] { try { AFS::removeFilePlain(dbPathRightTmp); } catch (FileError&) {} });
+
+            AFS::removeFileIfExists(journalPathLeft);               //throw FileError
+            AFS::moveAndRenameItem(dbPathLeftTmp, journalPathLeft); //throw FileError, (ErrorDifferentVolume)
+            guardTmpL.dismiss();
+
+            AFS::removeFileIfExists(journalPathRight);                //
+            AFS::moveAndRenameItem(dbPathRightTmp, journalPathRight); //
+            guardTmpR.dismiss();
+            return;
+        }
+        //else: compact journal into new snapshot
+    }
 
     //serialize again
     SessionData sessionDataL = {};
@@ -915,4 +1375,28 @@ void fff::saveLastSynchronousState(const BaseFolderPair& baseFolder, const std::
     AFS::removeFileIfExists(dbPathRight);                //
     AFS::moveAndRenameItem(dbPathRightTmp, dbPathRight); //
     guardTmpR.dismiss();
+
+    //remove journal records of the replaced session: not strictly needed (orphaned records are never replayed), but don't let them pile up
+    auto cleanUpJournal = [&](DbJournal& journal, const DbStreams& streams, const AbstractPath& journalPath, const AbstractPath& journalPathTmp, const IOCallback& notifySave)
+    {
+        const size_t sessionCountOld = journal.size();
+        removeObsoleteSessions(journal, streams);
+
+        if (journal.size() != sessionCountOld || journalCorrupted)
+        {
+            if (journal.empty())
+                AFS::removeFileIfExists(journalPath); //throw FileError
+            else
+            {
+                saveJournal(journal, journalPathTmp, notifySave); //throw FileError, X
+                auto guardTmp = makeGuard<ScopeGuardRunMode::ON_FAIL>([&] { try { AFS::removeFilePlain(journalPathTmp); } catch (FileError&) {} });
+
+                AFS::removeFileIfExists(journalPath);               //throw FileError
+                AFS::moveAndRenameItem(journalPathTmp, journalPath); //throw FileError, (ErrorDifferentVolume)
+                guardTmp.dismiss();
+            }
+        }
+    };
+    cleanUpJournal(journalLeft,  streamsLeft,  journalPathLeft,  dbPathLeftTmp,  notifySaveL); //throw FileError, X
+    cleanUpJournal(journalRight, streamsRight, journalPathRight, dbPathRightTmp, notifySaveR); //
 }
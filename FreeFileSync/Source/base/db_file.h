@@ -65,9 +65,9 @@ struct InSyncFolder
     InSyncStatus status = DIR_STATUS_STRAW_MAN;
 
     //------------------------------------------------------------------
-    using FolderList  = std::map<Zstring, InSyncFolder,  LessUnicodeNormal>; //
-    using FileList    = std::map<Zstring, InSyncFile,    LessUnicodeNormal>; // key: file name (ignoring Unicode normal forms)
-    using SymlinkList = std::map<Zstring, InSyncSymlink, LessUnicodeNormal>; //
+    using FolderList  = std::map<ZstringNorm, InSyncFolder >; //
+    using FileList    = std::map<ZstringNorm, InSyncFile   >; // key: file name (ignoring Unicode normal forms)
+    using SymlinkList = std::map<ZstringNorm, InSyncSymlink>; //
     //------------------------------------------------------------------
 
     FolderList  folders;
@@ -11,11 +11,16 @@
 #include <string>
 #include <memory>
 #include <list>
-#include <functional>
+#include <array>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include <unordered_set>
+#include <functional>
 #include <zen/zstring.h>
 #include <zen/stl_tools.h>
 #include <zen/file_id_def.h>
+#include <zen/node_arena.h>
 #include "structures.h"
 #include "path_filter.h"
 #include "../fs/abstract.h"
@@ -197,9 +202,9 @@ class ContainerObject : public virtual PathInformation
     friend class FileSystemObject;
 
 public:
-    using FileList    = std::list<FilePair>;    //MergeSides::execute() requires a structure that doesn't invalidate pointers after push_back()
-    using SymlinkList = std::list<SymlinkPair>; //
-    using FolderList  = std::list<FolderPair>;
+    using FileList    = std::list<FilePair,    zen::ArenaAllocator<FilePair>>;    //MergeSides::execute() requires a structure that doesn't invalidate pointers after push_back()
+    using SymlinkList = std::list<SymlinkPair, zen::ArenaAllocator<SymlinkPair>>; //
+    using FolderList  = std::list<FolderPair,  zen::ArenaAllocator<FolderPair>>;  //nodes are allocated from the BaseFolderPair's arena
 
     FolderPair& addSubFolder(const Zstring&          itemNameL,
                              const FolderAttributes& left,    //file exists on both sides
@@ -243,7 +248,10 @@ public:
     BaseFolderPair& getBase() { return base_; }
 
 protected:
-    ContainerObject(BaseFolderPair& baseFolder) : //used during BaseFolderPair constructor
+    ContainerObject(BaseFolderPair& baseFolder, zen::NodeArena& arena) : //used during BaseFolderPair constructor
+        subFiles_  (zen::ArenaAllocator<FilePair>   (arena)),
+        subLinks_  (zen::ArenaAllocator<SymlinkPair>(arena)),
+        subFolders_(zen::ArenaAllocator<FolderPair> (arena)),
         base_(baseFolder) {} //take reference only: baseFolder *not yet* fully constructed at this point!
 
     ContainerObject(const FileSystemObject& fsAlias); //used during FolderPair constructor
@@ -278,7 +286,8 @@ private:
 
 //------------------------------------------------------------------
 
-class BaseFolderPair : public ContainerObject //synchronization base directory
+class BaseFolderPair : private zen::NodeArena, public ContainerObject //synchronization base directory
+//NodeArena: memory of all child objects => base class constructed before and destroyed after ContainerObject!
 {
 public:
     BaseFolderPair(const AbstractPath& folderPathLeft,
@@ -289,7 +298,7 @@ public:
                    CompareVariant cmpVar,
                    int fileTimeTolerance,
                    const std::vector<unsigned int>& ignoreTimeShiftMinutes) :
-        ContainerObject(*this), //trust that ContainerObject knows that *this is not yet fully constructed!
+        ContainerObject(*this, static_cast<zen::NodeArena&>(*this)), //trust that ContainerObject knows that *this is not yet fully constructed!
         filter_(filter), cmpVar_(cmpVar), fileTimeTolerance_(fileTimeTolerance), ignoreTimeShiftMinutes_(ignoreTimeShiftMinutes),
         folderAvailableLeft_ (folderAvailableLeft),
         folderAvailableRight_(folderAvailableRight),
@@ -373,41 +382,143 @@ struct FSObjectVisitor
 };
 
 
+template <class T> class ObjectMgr;
+
+//weak reference to an ObjectMgr object: slot index + generation => O(1) validation without hashing
+template <class T, bool isConst>
+class ObjectIdImpl
+{
+public:
+    ObjectIdImpl() {}
+    ObjectIdImpl(std::nullptr_t) {}
+    ObjectIdImpl(const ObjectIdImpl<T, false>& id) : slot_(id.slot_), generation_(id.generation_) {} //ObjectId => ObjectIdConst (like pointers)
+
+    explicit operator bool() const { return generation_ != 0; }
+
+    friend bool operator==(const ObjectIdImpl& lhs, const ObjectIdImpl& rhs) { return lhs.slot_ == rhs.slot_ && lhs.generation_ == rhs.generation_; }
+    friend bool operator!=(const ObjectIdImpl& lhs, const ObjectIdImpl& rhs) { return !(lhs == rhs); }
+
+    size_t hash() const { return (static_cast<size_t>(generation_) << 32) ^ slot_; }
+
+private:
+    ObjectIdImpl(uint32_t slot, uint32_t generation) : slot_(slot), generation_(generation) {}
+
+    friend class ObjectIdImpl<T, !isConst>;
+    friend class ObjectMgr<T>;
+
+    uint32_t slot_       = 0;
+    uint32_t generation_ = 0; //0: null ID
+};
+
+
 //inherit from this class to allow safe random access by id instead of unsafe raw pointer
 //allow for similar semantics like std::weak_ptr without having to use std::shared_ptr
 template <class T>
 class ObjectMgr
 {
 public:
-    using ObjectId      =       ObjectMgr* ;
-    using ObjectIdConst = const ObjectMgr*;
+    using ObjectId      = ObjectIdImpl<T, false>;
+    using ObjectIdConst = ObjectIdImpl<T, true>;
 
-    ObjectIdConst  getId() const { return this; }
-    /**/  ObjectId getId()       { return this; }
+    ObjectIdConst  getId() const { return { slot_, generation_ }; }
+    /**/  ObjectId getId()       { return { slot_, generation_ }; }
 
     static const T* retrieve(ObjectIdConst id) //returns nullptr if object is not valid anymore
     {
-        const auto& aObj = activeObjects();
-        return static_cast<const T*>(aObj.find(id) == aObj.end() ? nullptr : id);
+        if (!id)
+            return nullptr;
+        //lock-free: slot chunks are never freed => a valid ID always references initialized memory
+        const Slot& slot = getSlot(id.slot_);
+        return slot.generation.load(std::memory_order_acquire) == id.generation_ ? static_cast<const T*>(slot.object.load(std::memory_order_relaxed)) : nullptr;
     }
     static T* retrieve(ObjectId id) { return const_cast<T*>(retrieve(static_cast<ObjectIdConst>(id))); }
 
 protected:
-    ObjectMgr () { activeObjects().insert(this); }
-    ~ObjectMgr() { activeObjects().erase (this); }
+    ObjectMgr() //throw std::bad_alloc
+    {
+        //thread-safe: objects are created concurrently by MergeSides worker threads during comparison
+        //=> one slot table per shard, selected by thread to avoid lock contention
+        const size_t shardIdx = std::hash<std::thread::id>()(std::this_thread::get_id()) % SHARD_COUNT;
+        Registry& reg = getRegistry()[shardIdx];
+        std::lock_guard dummy(reg.lockSlots);
+
+        uint32_t localIdx = 0;
+        if (!reg.freeSlots.empty())
+        {
+            localIdx = reg.freeSlots.back();
+            /**/       reg.freeSlots.pop_back();
+        }
+        else
+        {
+            if (reg.slotCount == CHUNK_SLOTS * MAX_CHUNKS)
+                throw std::bad_alloc();
+
+            localIdx = reg.slotCount++;
+            if (localIdx % CHUNK_SLOTS == 0)
+                reg.chunks[localIdx / CHUNK_SLOTS].store(new Slot[CHUNK_SLOTS], std::memory_order_release); //never freed: IDs may outlive all objects
+        }
+        slot_ = static_cast<uint32_t>(localIdx * SHARD_COUNT + shardIdx);
+
+        Slot& slot = getSlot(slot_);
+        generation_ = slot.generation.load(std::memory_order_relaxed);
+        if (generation_ == 0) //fresh slot
+            generation_ = 1;
+
+        slot.object.store(this, std::memory_order_relaxed);
+        slot.generation.store(generation_, std::memory_order_release);
+    }
+
+    ~ObjectMgr()
+    {
+        Registry& reg = getRegistry()[slot_ % SHARD_COUNT];
+        std::lock_guard dummy(reg.lockSlots);
+
+        Slot& slot = getSlot(slot_);
+        uint32_t nextGen = generation_ + 1;
+        if (nextGen == 0) //skip null ID on overflow
+            nextGen = 1;
+        slot.generation.store(nextGen, std::memory_order_release); //invalidate all IDs referencing this object
+        slot.object.store(nullptr, std::memory_order_relaxed);
+
+        reg.freeSlots.push_back(slot_ / SHARD_COUNT);
+    }
 
 private:
     ObjectMgr           (const ObjectMgr& rhs) = delete;
     ObjectMgr& operator=(const ObjectMgr& rhs) = delete; //it's not well-defined what copying an objects means regarding object-identity in this context
 
-    static std::unordered_set<const ObjectMgr*>& activeObjects()
+    static constexpr size_t SHARD_COUNT = 16;
+    static constexpr size_t CHUNK_SLOTS = 16 * 1024;
+    static constexpr size_t MAX_CHUNKS  = 16 * 1024; //=> max. 2^32 objects (with SHARD_COUNT)
+
+    struct Slot
+    {
+        std::atomic<ObjectMgr*> object{nullptr};
+        std::atomic<uint32_t> generation{0}; //ID currently valid for this slot (or next ID if empty)
+    };
+
+    struct Registry
     {
-        //our global ObjectMgr is not thread-safe (and currently does not need to be!)
-        //assert(runningMainThread()); -> still, may be accessed by synchronization worker threads, one thread at a time
+        std::mutex lockSlots;
+        std::vector<uint32_t> freeSlots; //local slot indexes
+        size_t slotCount = 0;
+        std::array<std::atomic<Slot*>, MAX_CHUNKS> chunks{};
+    };
 
-        static std::unordered_set<const ObjectMgr*> inst;
+    static std::array<Registry, SHARD_COUNT>& getRegistry()
+    {
+        static std::array<Registry, SHARD_COUNT> inst;
         return inst; //external linkage (even in header file!)
     }
+
+    static Slot& getSlot(uint32_t slotIdx)
+    {
+        const size_t localIdx = slotIdx / SHARD_COUNT;
+        return getRegistry()[slotIdx % SHARD_COUNT].chunks[localIdx / CHUNK_SLOTS].load(std::memory_order_acquire)[localIdx % CHUNK_SLOTS];
+    }
+
+    uint32_t slot_;
+    uint32_t generation_;
 };
 
 //------------------------------------------------------------------
@@ -539,7 +650,13 @@ private:
     void flip         () override;
     void removeObjectL() override;
     void removeObjectR() override;
-    void notifySyncCfgChanged() override { syncOpBuffered_ = {}; FileSystemObject::notifySyncCfgChanged(); ContainerObject::notifySyncCfgChanged(); }
+    void notifySyncCfgChanged() override
+    {
+        if (syncOpBuffered_) //read-only if nothing is buffered: MergeSides worker threads notify shared parent folders concurrently
+            syncOpBuffered_ = {};
+        FileSystemObject::notifySyncCfgChanged();
+        ContainerObject::notifySyncCfgChanged();
+    }
 
     mutable std::optional<SyncOperation> syncOpBuffered_; //determining sync-op for directory may be expensive as it depends on child-objects => buffer
 
@@ -565,7 +682,9 @@ public:
              ContainerObject& parentObj) :
         FileSystemObject(itemNameL, itemNameR, parentObj, defaultCmpResult),
         attrL_(attrL),
-        attrR_(attrR) {}
+        attrR_(attrR),
+        isFollowedSymlinkL_(attrL.isFollowedSymlink),
+        isFollowedSymlinkR_(attrR.isFollowedSymlink) {}
 
     template <SelectedSide side> time_t      getLastWriteTime() const;
     template <SelectedSide side> uint64_t         getFileSize() const;
@@ -597,14 +716,28 @@ private:
 
     SyncOperation applyMoveOptimization(SyncOperation op) const;
 
+    template <SelectedSide side>
+    void setAttributes(const FileAttributes& attr);
+
     void flip         () override;
-    void removeObjectL() override { attrL_ = FileAttributes(); }
-    void removeObjectR() override { attrR_ = FileAttributes(); }
+    void removeObjectL() override { setAttributes< LEFT_SIDE>(FileAttributes()); }
+    void removeObjectR() override { setAttributes<RIGHT_SIDE>(FileAttributes()); }
+
+    struct FileData //= FileAttributes without isFollowedSymlink: store both flags together => -8 bytes per FilePair
+    {
+        FileData(const FileAttributes& attr) : modTime(attr.modTime), fileSize(attr.fileSize), fileId(attr.fileId) {}
 
-    FileAttributes attrL_;
-    FileAttributes attrR_;
+        time_t modTime;
+        uint64_t fileSize;
+        AFS::FileId fileId;
+    };
+    FileData attrL_;
+    FileData attrR_;
 
     ObjectId moveFileRef_ = nullptr; //optional, filled by redetermineSyncDirection()
+
+    bool isFollowedSymlinkL_;
+    bool isFollowedSymlinkR_;
 };
 
 //------------------------------------------------------------------
@@ -927,6 +1060,9 @@ void ContainerObject::updateRelPathsRecursion(const FileSystemObject& fsAlias)
 
 inline
 ContainerObject::ContainerObject(const FileSystemObject& fsAlias) :
+    subFiles_  (fsAlias.parent().subFiles_  .get_allocator()), //
+    subLinks_  (fsAlias.parent().subLinks_  .get_allocator()), //share arena of BaseFolderPair
+    subFolders_(fsAlias.parent().subFolders_.get_allocator()), //
     relPathL_(nativeAppendPaths(fsAlias.parent().relPathL_, fsAlias.getItemName<LEFT_SIDE>())),
     relPathR_(
         fsAlias.parent().relPathL_.c_str() ==        //
@@ -1104,13 +1240,23 @@ void FilePair::flip()
 {
     FileSystemObject::flip(); //call base class version
     std::swap(attrL_, attrR_);
+    std::swap(isFollowedSymlinkL_, isFollowedSymlinkR_);
 }
 
 
 template <SelectedSide side> inline
 FileAttributes FilePair::getAttributes() const
 {
-    return SelectParam<side>::ref(attrL_, attrR_);
+    const FileData& attr = SelectParam<side>::ref(attrL_, attrR_);
+    return FileAttributes(attr.modTime, attr.fileSize, attr.fileId, isFollowedSymlink<side>());
+}
+
+
+template <SelectedSide side> inline
+void FilePair::setAttributes(const FileAttributes& attr)
+{
+    SelectParam<side>::ref(attrL_, attrR_) = attr;
+    SelectParam<side>::ref(isFollowedSymlinkL_, isFollowedSymlinkR_) = attr.isFollowedSymlink;
 }
 
 
@@ -1138,7 +1284,7 @@ AFS::FileId FilePair::getFileId() const
 template <SelectedSide side> inline
 bool FilePair::isFollowedSymlink() const
 {
-    return SelectParam<side>::ref(attrL_, attrR_).isFollowedSymlink;
+    return SelectParam<side>::ref(isFollowedSymlinkL_, isFollowedSymlinkR_);
 }
 
 
@@ -1162,8 +1308,8 @@ void FilePair::setSyncedTo(const Zstring& itemName,
     //FILE_EQUAL is only allowed for same short name and file size: enforced by this method!
     constexpr SelectedSide sideSrc = OtherSide<sideTrg>::value;
 
-    SelectParam<sideTrg>::ref(attrL_, attrR_) = FileAttributes(lastWriteTimeTrg, fileSize, fileIdTrg, isSymlinkTrg);
-    SelectParam<sideSrc>::ref(attrL_, attrR_) = FileAttributes(lastWriteTimeSrc, fileSize, fileIdSrc, isSymlinkSrc);
+    setAttributes<sideTrg>(FileAttributes(lastWriteTimeTrg, fileSize, fileIdTrg, isSymlinkTrg));
+    setAttributes<sideSrc>(FileAttributes(lastWriteTimeSrc, fileSize, fileIdSrc, isSymlinkSrc));
 
     moveFileRef_ = nullptr;
     FileSystemObject::setSynced(itemName); //set FileSystemObject specific part
@@ -1220,4 +1366,11 @@ void SymlinkPair::flip()
 }
 }
 
+
+template <class T, bool isConst>
+struct std::hash<fff::ObjectIdImpl<T, isConst>>
+{
+    size_t operator()(const fff::ObjectIdImpl<T, isConst>& id) const { return id.hash(); }
+};
+
 #endif //FILE_HIERARCHY_H_257235289645296
@@ -0,0 +1,154 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "hash_cache.h"
+#include <zen/guid.h>
+#include <zen/crc.h>
+#include <zen/zlib_wrap.h>
+
+using namespace zen;
+using namespace fff;
+
+
+namespace
+{
+//-------------------------------------------------------------------------------------------------------------------------------
+const char FILE_FORMAT_DESCR[] = "FreeFileSync";
+const int HASH_CACHE_FORMAT = 1; //since 2026-10-16
+//-------------------------------------------------------------------------------------------------------------------------------
+
+/*------------------------------------------------------------------------------
+  | ensure 32/64 bit portability: use fixed size data types only e.g. uint32_t |
+  ------------------------------------------------------------------------------*/
+
+AbstractPath getHashCacheFilePath(const AbstractPath& baseFolderPath, bool tempfile = false)
+{
+    const Zstring cacheName = Zstr(".sync"); //files beginning with dots are hidden e.g. in Nautilus
+    Zstring cacheFileName;
+    if (tempfile) //generate (hopefully) unique file name to avoid clashing with some remnant ffs_tmp file
+    {
+        const Zstring shortGuid = printNumber<Zstring>(Zstr("%04x"), static_cast<unsigned int>(getCrc16(generateGUID())));
+        cacheFileName = cacheName + Zstr('.') + shortGuid + AFS::TEMP_FILE_ENDING;
+    }
+    else
+        cacheFileName = cacheName + CONTENT_HASH_FILE_ENDING;
+
+    return AFS::appendRelPath(baseFolderPath, cacheFileName);
+}
+}
+
+
+ContentHashCache fff::loadContentHashCache(const AbstractPath& baseFolderPath) //throw FileError
+{
+    const AbstractPath cachePath = getHashCacheFilePath(baseFolderPath);
+    ByteArray rawStream;
+    try
+    {
+        const std::unique_ptr<AFS::InputStream> fileStreamIn = AFS::getInputStream(cachePath, nullptr /*notifyUnbufferedIO*/); //throw FileError, ErrorFileLocked
+
+        //read FreeFileSync file identifier
+        char formatDescr[sizeof(FILE_FORMAT_DESCR)] = {};
+        readArray(*fileStreamIn, formatDescr, sizeof(formatDescr)); //throw FileError, ErrorFileLocked, UnexpectedEndOfStreamError
+
+        if (!std::equal(FILE_FORMAT_DESCR, FILE_FORMAT_DESCR + sizeof(FILE_FORMAT_DESCR), formatDescr) ||
+            readNumber<int32_t>(*fileStreamIn) != HASH_CACHE_FORMAT) //throw FileError, ErrorFileLocked, UnexpectedEndOfStreamError
+            throw FileError(replaceCpy(_("Database file %x is incompatible."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))));
+
+        rawStream = readContainer<ByteArray>(*fileStreamIn); //throw FileError, ErrorFileLocked, UnexpectedEndOfStreamError
+    }
+    catch (FileError&)
+    {
+        bool cacheNotYetExisting = false;
+        try { cacheNotYetExisting = !AFS::itemStillExists(cachePath); /*throw FileError*/ }
+        catch (FileError&) {} //previous exception is more relevant
+
+        if (cacheNotYetExisting)
+            return {};
+        throw;
+    }
+    catch (UnexpectedEndOfStreamError&)
+    {
+        throw FileError(_("Database file is corrupted:") + L"\n" + fmtPath(AFS::getDisplayPath(cachePath)), L"Unexpected end of stream.");
+    }
+
+    try
+    {
+        MemoryStreamIn<ByteArray> streamIn(decompress(rawStream)); //throw ZlibInternalError
+
+        ContentHashCache output;
+        size_t itemCount = readNumber<uint32_t>(streamIn); //throw UnexpectedEndOfStreamError
+        output.reserve(itemCount);
+
+        while (itemCount-- != 0)
+        {
+            const Zstring relPath = utfTo<Zstring>(readContainer<Zbase<char>>(streamIn)); //throw UnexpectedEndOfStreamError
+
+            CachedContentHash& entry = output[relPath];
+            entry.fileId           = readContainer<AFS::FileId>(streamIn); //
+            entry.fileSize         = readNumber<uint64_t>(streamIn);       //
+            entry.modTime          = readNumber<int64_t>(streamIn);        //throw UnexpectedEndOfStreamError
+            entry.contentHash.low  = readNumber<uint64_t>(streamIn);       //
+            entry.contentHash.high = readNumber<uint64_t>(streamIn);       //
+        }
+        return output;
+    }
+    catch (ZlibInternalError&)
+    {
+        throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))), L"Zlib internal error");
+    }
+    catch (UnexpectedEndOfStreamError&)
+    {
+        throw FileError(_("Database file is corrupted:") + L"\n" + fmtPath(AFS::getDisplayPath(cachePath)), L"Unexpected end of stream.");
+    }
+}
+
+
+void fff::saveContentHashCache(const AbstractPath& baseFolderPath, const ContentHashCache& hashCache) //throw FileError
+{
+    const AbstractPath cachePath    = getHashCacheFilePath(baseFolderPath);
+    const AbstractPath cachePathTmp = getHashCacheFilePath(baseFolderPath, true /*tempfile*/);
+
+    MemoryStreamOut<ByteArray> streamOut;
+    writeNumber(streamOut, static_cast<uint32_t>(hashCache.size()));
+
+    for (const auto& [relPath, entry] : hashCache)
+    {
+        writeContainer(streamOut, utfTo<Zbase<char>>(relPath));
+        writeContainer(streamOut, entry.fileId);
+        writeNumber<uint64_t>(streamOut, entry.fileSize);
+        writeNumber<int64_t >(streamOut, entry.modTime);
+        writeNumber<uint64_t>(streamOut, entry.contentHash.low);
+        writeNumber<uint64_t>(streamOut, entry.contentHash.high);
+    }
+
+    ByteArray rawStream;
+    try
+    {
+        rawStream = compress(streamOut.ref(), 3); //throw ZlibInternalError; same level as sync.ffs_db
+    }
+    catch (ZlibInternalError&)
+    {
+        throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(AFS::getDisplayPath(cachePath))), L"zlib internal error");
+    }
+
+    //write temp file first: don't leave a truncated cache behind
+    auto guardTmp = makeGuard<ScopeGuardRunMode::ON_FAIL>([&] { try { AFS::removeFilePlain(cachePathTmp); } catch (FileError&) {} });
+    {
+        const std::unique_ptr<AFS::OutputStream> fileStreamOut = AFS::getOutputStream(cachePathTmp, //throw FileError
+                                                                                      std::nullopt /*streamSize*/,
+                                                                                      std::nullopt /*modTime*/,
+                                                                                      nullptr /*notifyUnbufferedIO*/);
+        writeArray(*fileStreamOut, FILE_FORMAT_DESCR, sizeof(FILE_FORMAT_DESCR)); //throw FileError
+        writeNumber<int32_t>(*fileStreamOut, HASH_CACHE_FORMAT);                  //
+        writeContainer<ByteArray>(*fileStreamOut, rawStream);                      //
+
+        fileStreamOut->finalize(); //throw FileError
+    }
+
+    AFS::removeFileIfExists(cachePath);              //throw FileError
+    AFS::moveAndRenameItem(cachePathTmp, cachePath); //throw FileError, (ErrorDifferentVolume)
+    guardTmp.dismiss();
+}
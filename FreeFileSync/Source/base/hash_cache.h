@@ -0,0 +1,45 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef HASH_CACHE_H_4718302957163098
+#define HASH_CACHE_H_4718302957163098
+
+#include <unordered_map>
+#include <zen/file_error.h>
+#include <zen/murmur_hash.h>
+#include "structures.h"
+
+
+namespace fff
+{
+const Zchar CONTENT_HASH_FILE_ENDING[] = Zstr(".ffs_hash"); //don't use Zstring as global constant: avoid static initialization order problem in global namespace!
+
+//content hash of a file as of its last full read during comparison by content
+struct CachedContentHash
+{
+    AFS::FileId fileId;
+    uint64_t fileSize = 0;
+    time_t modTime = 0;
+    zen::Hash128 contentHash;
+};
+inline bool operator==(const CachedContentHash& lhs, const CachedContentHash& rhs)
+{
+    return lhs.fileId      == rhs.fileId   &&
+           lhs.fileSize    == rhs.fileSize &&
+           lhs.modTime     == rhs.modTime  &&
+           lhs.contentHash == rhs.contentHash;
+}
+
+using ContentHashCache = std::unordered_map<Zstring, CachedContentHash, zen::StringHash>; //key: file path relative to base folder
+
+
+//one cache file per base folder: independent from the folder it is compared against
+ContentHashCache loadContentHashCache(const AbstractPath& baseFolderPath); //throw FileError; return empty cache if not yet existing
+
+void saveContentHashCache(const AbstractPath& baseFolderPath, const ContentHashCache& hashCache); //throw FileError
+}
+
+#endif //HASH_CACHE_H_4718302957163098
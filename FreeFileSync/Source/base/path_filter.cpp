@@ -10,6 +10,7 @@
 #include <vector>
 #include <typeinfo>
 #include <iterator>
+#include <string_view>
 
 using namespace zen;
 using namespace fff;
@@ -216,9 +217,126 @@ bool matchesMaskBegin(const Zstring& name, const std::vector<Zstring>& masks)
 {
     return std::any_of(masks.begin(), masks.end(), [&](const Zstring& mask) { return matchesMaskBegin(name.c_str(), mask.c_str()); });
 }
+
+
+//normalize input: 1. ignore Unicode normalization form 2. ignore case
+template <class Function> inline
+bool evalUpperCase(const Zstring& relPath, Function evalPath) //evalPath: bool(const Zchar* pathFmt, size_t pathLen)
+{
+    //perf: ASCII-only paths (= the vast majority) are folded on the stack => no memory allocation per file
+    constexpr size_t ASCII_BUF_SIZE = 1024;
+    if (relPath.size() < ASCII_BUF_SIZE)
+    {
+        Zchar pathFmt[ASCII_BUF_SIZE];
+        if (makeUpperAscii(relPath.c_str(), relPath.size(), pathFmt))
+        {
+            pathFmt[relPath.size()] = 0;
+            return evalPath(static_cast<const Zchar*>(pathFmt), relPath.size());
+        }
+    }
+
+    const Zstring& pathFmt = makeUpperCopy(relPath);
+    return evalPath(pathFmt.c_str(), pathFmt.size());
+}
+
+
+using ZstringView = std::basic_string_view<Zchar>;
+
+struct LessView
+{
+    bool operator()(const Zstring& lhs, const Zstring& rhs) const { return ZstringView(lhs.c_str(), lhs.size()) < ZstringView(rhs.c_str(), rhs.size()); }
+    bool operator()(const Zstring& lhs, ZstringView     rhs) const { return ZstringView(lhs.c_str(), lhs.size()) < rhs; }
+    bool operator()(ZstringView     lhs, const Zstring& rhs) const { return lhs < ZstringView(rhs.c_str(), rhs.size()); }
+};
 }
 
 
+/*  Most filter masks in real-world lists are either plain relative paths ("\folder\file.txt") or a file name/ending
+    ("*.tmp", "*\thumbs.db"): both are matched via binary search for all masks at once:
+
+    - literal mask: match iff a path prefix ending before a separator (or at path end for AnyMatch) equals the mask
+    - "*literal":   match iff such a path prefix ends with the literal  => grouped by literal length
+
+    all other masks: fall back to matchesMask(), but only if the path contains the mask's first literal run (or starts with it, if the mask does):
+    grouped by this run, e.g. "*\\~$*" masks are all skipped by a single search                                                                */
+class NameFilter::MaskIndex
+{
+public:
+    explicit MaskIndex(const std::vector<Zstring>& masks)
+    {
+        for (const Zstring& mask : masks)
+        {
+            auto isWildcard = [](Zchar c) { return c == Zstr('*') || c == Zstr('?'); };
+
+            if (std::none_of(mask.begin(), mask.end(), isWildcard))
+                literals_.push_back(mask);
+            else if (mask.size() > 1 && mask[0] == Zstr('*') && std::none_of(mask.begin() + 1, mask.end(), isWildcard))
+            {
+                const Zstring tail(mask.begin() + 1, mask.end());
+                auto it = std::find_if(tails_.begin(), tails_.end(), [&](const auto& item) { return item.first == tail.size(); });
+                if (it == tails_.end())
+                    it = tails_.insert(tails_.end(), { tail.size(), {} });
+                it->second.push_back(tail);
+            }
+            else
+            {
+                const auto itAnchorBegin = std::find_if_not(mask.begin(), mask.end(), isWildcard);
+                const auto itAnchorEnd   = std::find_if    (itAnchorBegin, mask.end(), isWildcard);
+                const Zstring anchor(itAnchorBegin, itAnchorEnd);
+                const bool anchorAtStart = itAnchorBegin == mask.begin();
+
+                auto it = std::find_if(otherMasks_.begin(), otherMasks_.end(), [&](const MaskGroup& grp) { return grp.anchor == anchor && grp.anchorAtStart == anchorAtStart; });
+                if (it == otherMasks_.end())
+                    it = otherMasks_.insert(otherMasks_.end(), { anchor, anchorAtStart, {} });
+                it->masks.push_back(mask);
+            }
+        }
+
+        std::sort(literals_.begin(), literals_.end(), LessView());
+        for (auto& [tailLen, tails] : tails_)
+            std::sort(tails.begin(), tails.end(), LessView());
+    }
+
+    template <class PathEndMatcher>
+    bool matches(const Zchar* path, size_t pathLen) const
+    {
+        if (!literals_.empty() || !tails_.empty())
+            for (size_t pos = 0; pos <= pathLen; ++pos)
+                if (PathEndMatcher::matchesMaskEnd(path + pos))
+                {
+                    if (std::binary_search(literals_.begin(), literals_.end(), ZstringView(path, pos), LessView()))
+                        return true;
+
+                    for (const auto& [tailLen, tails] : tails_)
+                        if (tailLen <= pos && std::binary_search(tails.begin(), tails.end(), ZstringView(path + pos - tailLen, tailLen), LessView()))
+                            return true;
+                }
+
+        const ZstringView pathView(path, pathLen);
+        for (const MaskGroup& grp : otherMasks_)
+            if (grp.anchorAtStart ?
+                pathView.substr(0, grp.anchor.size()) == ZstringView(grp.anchor.c_str(), grp.anchor.size()) :
+                pathView.find(ZstringView(grp.anchor.c_str(), grp.anchor.size())) != ZstringView::npos)
+                for (const Zstring& mask : grp.masks)
+                    if (matchesMask<PathEndMatcher>(path, mask.c_str()))
+                        return true;
+        return false;
+    }
+
+private:
+    struct MaskGroup
+    {
+        Zstring anchor; //first run of literal chars: must be contained in matching paths
+        bool anchorAtStart;
+        std::vector<Zstring> masks;
+    };
+
+    std::vector<Zstring> literals_;                              //sorted
+    std::vector<std::pair<size_t, std::vector<Zstring>>> tails_; //"*literal" => literal length, sorted literals
+    std::vector<MaskGroup> otherMasks_;
+};
+
+
 std::vector<Zstring> fff::splitByDelimiter(const Zstring& filterPhrase)
 {
     //delimiters may be FILTER_ITEM_SEPARATOR or '\n'
@@ -247,6 +365,8 @@ NameFilter::NameFilter(const Zstring& includePhrase, const Zstring& excludePhras
     removeDuplicates(includeMasksFolder);
     removeDuplicates(excludeMasksFileFolder);
     removeDuplicates(excludeMasksFolder);
+
+    compileMasks();
 }
 
 
@@ -256,6 +376,17 @@ void NameFilter::addExclusion(const Zstring& excludePhrase)
 
     removeDuplicates(excludeMasksFileFolder);
     removeDuplicates(excludeMasksFolder);
+
+    compileMasks();
+}
+
+
+void NameFilter::compileMasks()
+{
+    includeIndexFileFolder = std::make_shared<const MaskIndex>(includeMasksFileFolder);
+    includeIndexFolder     = std::make_shared<const MaskIndex>(includeMasksFolder);
+    excludeIndexFileFolder = std::make_shared<const MaskIndex>(excludeMasksFileFolder);
+    excludeIndexFolder     = std::make_shared<const MaskIndex>(excludeMasksFolder);
 }
 
 
@@ -263,15 +394,15 @@ bool NameFilter::passFileFilter(const Zstring& relFilePath) const
 {
     assert(!startsWith(relFilePath, FILE_NAME_SEPARATOR));
 
-    //normalize input: 1. ignore Unicode normalization form 2. ignore case
-    const Zstring& pathFmt = makeUpperCopy(relFilePath);
-
-    if (matchesMask<AnyMatch         >(pathFmt, excludeMasksFileFolder) || //either full match on file or partial match on any parent folder
-        matchesMask<ParentFolderMatch>(pathFmt, excludeMasksFolder))       //partial match on any parent folder only
-        return false;
+    return evalUpperCase(relFilePath, [&](const Zchar* pathFmt, size_t pathLen)
+    {
+        if (excludeIndexFileFolder->matches<AnyMatch         >(pathFmt, pathLen) || //either full match on file or partial match on any parent folder
+            excludeIndexFolder    ->matches<ParentFolderMatch>(pathFmt, pathLen))   //partial match on any parent folder only
+            return false;
 
-    return matchesMask<AnyMatch         >(pathFmt, includeMasksFileFolder) ||
-           matchesMask<ParentFolderMatch>(pathFmt, includeMasksFolder);
+        return includeIndexFileFolder->matches<AnyMatch         >(pathFmt, pathLen) ||
+               includeIndexFolder    ->matches<ParentFolderMatch>(pathFmt, pathLen);
+    });
 }
 
 
@@ -280,11 +411,17 @@ bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMa
     assert(!startsWith(relDirPath, FILE_NAME_SEPARATOR));
     assert(!childItemMightMatch || *childItemMightMatch); //check correct usage
 
-    //normalize input: 1. ignore Unicode normalization form 2. ignore case
-    const Zstring& pathFmt = makeUpperCopy(relDirPath);
+    return evalUpperCase(relDirPath, [&](const Zchar* pathFmt, size_t pathLen)
+    {
+        return passDirFilterFmt(pathFmt, pathLen, childItemMightMatch);
+    });
+}
+
 
-    if (matchesMask<AnyMatch>(pathFmt, excludeMasksFileFolder) ||
-        matchesMask<AnyMatch>(pathFmt, excludeMasksFolder))
+bool NameFilter::passDirFilterFmt(const Zchar* pathFmt, size_t pathLen, bool* childItemMightMatch) const
+{
+    if (excludeIndexFileFolder->matches<AnyMatch>(pathFmt, pathLen) ||
+        excludeIndexFolder    ->matches<AnyMatch>(pathFmt, pathLen))
     {
         if (childItemMightMatch)
             *childItemMightMatch = false; //perf: no need to traverse deeper; subfolders/subfiles would be excluded by filter anyway!
@@ -302,12 +439,12 @@ bool NameFilter::passDirFilter(const Zstring& relDirPath, bool* childItemMightMa
         return false;
     }
 
-    if (!matchesMask<AnyMatch>(pathFmt, includeMasksFileFolder) &&
-        !matchesMask<AnyMatch>(pathFmt, includeMasksFolder))
+    if (!includeIndexFileFolder->matches<AnyMatch>(pathFmt, pathLen) &&
+        !includeIndexFolder    ->matches<AnyMatch>(pathFmt, pathLen))
     {
         if (childItemMightMatch)
         {
-            const Zstring& childPathBegin = pathFmt + FILE_NAME_SEPARATOR;
+            const Zstring& childPathBegin = Zstring(pathFmt, pathLen) + FILE_NAME_SEPARATOR;
 
             *childItemMightMatch = matchesMaskBegin(childPathBegin, includeMasksFileFolder) || //might match a file  or folder in subdirectory
                                    matchesMaskBegin(childPathBegin, includeMasksFolder);       //
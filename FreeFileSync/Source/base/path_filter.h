@@ -93,10 +93,19 @@ public:
 private:
     bool cmpLessSameType(const PathFilter& other) const override;
 
+    void compileMasks();
+    bool passDirFilterFmt(const Zchar* pathFmt, size_t pathLen, bool* childItemMightMatch) const;
+
     std::vector<Zstring> includeMasksFileFolder; //
     std::vector<Zstring> includeMasksFolder;     //upper-case + Unicode-normalized by construction
     std::vector<Zstring> excludeMasksFileFolder; //
     std::vector<Zstring> excludeMasksFolder;     //
+
+    class MaskIndex; //masks compiled for matching a path without evaluating each mask in turn
+    std::shared_ptr<const MaskIndex> includeIndexFileFolder; //
+    std::shared_ptr<const MaskIndex> includeIndexFolder;     //immutable: shared between NameFilter copies
+    std::shared_ptr<const MaskIndex> excludeIndexFileFolder; //
+    std::shared_ptr<const MaskIndex> excludeIndexFolder;     //
 };
 
 
@@ -22,7 +22,7 @@ using namespace fff; //functionally needed for correct overload resolution!!!
 namespace
 {
 //-------------------------------------------------------------------------------------------------------------------------------
-const int XML_FORMAT_VER_GLOBAL  = 11; //2018-09-09
+const int XML_FORMAT_VER_GLOBAL  = 12; //2026-10-16
 const int XML_FORMAT_VER_FFS_CFG = 14; //2018-08-13
 //-------------------------------------------------------------------------------------------------------------------------------
 }
@@ -1086,7 +1086,7 @@ void readConfig(const XmlIn& in, FilterConfig& filter, int formatVer)
 }
 
 
-void readConfig(const XmlIn& in, LocalPairConfig& lpc, std::map<AfsDevice, size_t>& deviceParallelOps, int formatVer)
+void readConfig(const XmlIn& in, LocalPairConfig& lpc, std::map<AfsDevice, size_t>& deviceParallelOps, std::map<AfsDevice, size_t>& deviceParallelWrites, int formatVer)
 {
     //read folder pairs
     in["Left" ](lpc.folderPathPhraseLeft);
@@ -1127,6 +1127,22 @@ void readConfig(const XmlIn& in, LocalPairConfig& lpc, std::map<AfsDevice, size_
     setParallelOps(lpc.folderPathPhraseLeft,  parallelOpsL);
     setParallelOps(lpc.folderPathPhraseRight, parallelOpsR);
 
+    auto readParallelWrites = [&](const XmlElement* e, const Zstring& folderPathPhrase)
+    {
+        size_t parallelWrites = 0;
+        if (e && e->getAttribute("WriteThreads", parallelWrites) && parallelWrites > 0) //optional
+        {
+            const AfsDevice afsDevice = createAbstractPath(folderPathPhrase).afsDevice;
+            if (!AFS::isNullDevice(afsDevice))
+            {
+                auto it = deviceParallelWrites.find(afsDevice);
+                deviceParallelWrites[afsDevice] = it != deviceParallelWrites.end() ? std::max(it->second, parallelWrites) : parallelWrites;
+            }
+        }
+    };
+    readParallelWrites(in["Left" ].get(), lpc.folderPathPhraseLeft);
+    readParallelWrites(in["Right"].get(), lpc.folderPathPhraseRight);
+
     //TODO: remove after migration - 2016-07-24
     auto ciReplace = [](Zstring& pathPhrase, const Zstring& oldTerm, const Zstring& newTerm) { pathPhrase = replaceCpyAsciiNoCase(pathPhrase, oldTerm, newTerm); };
     ciReplace(lpc.folderPathPhraseLeft,  Zstr("%csidl_MyDocuments%"), Zstr("%csidl_Documents%"));
@@ -1214,7 +1230,7 @@ void readConfig(const XmlIn& in, MainConfiguration& mainCfg, int formatVer)
     for (XmlIn inPair = inMain["FolderPairs"]["Pair"]; inPair; inPair.next())
     {
         LocalPairConfig lpc;
-        readConfig(inPair, lpc, mainCfg.deviceParallelOps, formatVer);
+        readConfig(inPair, lpc, mainCfg.deviceParallelOps, mainCfg.deviceParallelWrites, formatVer);
 
         if (firstItem)
         {
@@ -1394,7 +1410,21 @@ void readConfig(const XmlIn& in, XmlGlobalSettings& cfg, int formatVer)
     inGeneral["FailSafeFileCopy"         ].attribute("Enabled", cfg.failSafeFileCopy);
     inGeneral["CopyLockedFiles"          ].attribute("Enabled", cfg.copyLockedFiles);
     inGeneral["CopyFilePermissions"      ].attribute("Enabled", cfg.copyFilePermissions);
+    //TODO: remove if parameter migration after some time! 2026-10-16
+    if (formatVer >= 12)
+    {
+        inGeneral["StripedFileCopy"].attribute("MinSizeMB", cfg.stripedCopyMinSizeMB);
+
+        size_t blockSizeKB = cfg.streamingIO.blockSize / 1024;
+        inGeneral["StreamingIO"].attribute("BlockSizeKB",   blockSizeKB);
+        inGeneral["StreamingIO"].attribute("DropPageCache", cfg.streamingIO.dropPageCache);
+        inGeneral["StreamingIO"].attribute("DirectIO",      cfg.streamingIO.directIO);
+        cfg.streamingIO.blockSize = blockSizeKB * 1024;
+    }
     inGeneral["FileTimeTolerance"        ].attribute("Seconds", cfg.fileTimeTolerance);
+    //TODO: remove if parameter migration after some time! 2026-10-16
+    if (formatVer >= 12)
+        inGeneral["CacheContentHashes"].attribute("Enabled", cfg.cacheContentHashes);
     inGeneral["RunWithBackgroundPriority"].attribute("Enabled", cfg.runWithBackgroundPriority);
     inGeneral["LockDirectoriesDuringSync"].attribute("Enabled", cfg.createLockFile);
     inGeneral["VerifyCopiedFiles"        ].attribute("Enabled", cfg.verifyFileCopy);
@@ -1922,7 +1952,7 @@ void writeConfig(const FilterConfig& filter, XmlOut& out)
 }
 
 
-void writeConfig(const LocalPairConfig& lpc, const std::map<AfsDevice, size_t>& deviceParallelOps, XmlOut& out)
+void writeConfig(const LocalPairConfig& lpc, const std::map<AfsDevice, size_t>& deviceParallelOps, const std::map<AfsDevice, size_t>& deviceParallelWrites, XmlOut& out)
 {
     XmlOut outPair = out.ref().addChild("Pair");
 
@@ -1936,6 +1966,15 @@ void writeConfig(const LocalPairConfig& lpc, const std::map<AfsDevice, size_t>&
     if (parallelOpsL > 1) outPair["Left" ].attribute("Threads", parallelOpsL);
     if (parallelOpsR > 1) outPair["Right"].attribute("Threads", parallelOpsR);
 
+    auto writeParallelWrites = [&](const Zstring& folderPathPhrase, XmlOut outFolder)
+    {
+        auto it = deviceParallelWrites.find(createAbstractPath(folderPathPhrase).afsDevice);
+        if (it != deviceParallelWrites.end())
+            outFolder.attribute("WriteThreads", it->second);
+    };
+    writeParallelWrites(lpc.folderPathPhraseLeft,  outPair["Left" ]);
+    writeParallelWrites(lpc.folderPathPhraseRight, outPair["Right"]);
+
     //avoid "fake" changed configs by only storing "real" parallel-enabled devices in deviceParallelOps
     assert(std::all_of(deviceParallelOps.begin(), deviceParallelOps.end(), [](const auto& item) { return item.second > 1; }));
 
@@ -1985,10 +2024,10 @@ void writeConfig(const MainConfiguration& mainCfg, XmlOut& out)
     //###########################################################
     XmlOut outFp = outMain["FolderPairs"];
     //write folder pairs
-    writeConfig(mainCfg.firstPair, mainCfg.deviceParallelOps, outFp);
+    writeConfig(mainCfg.firstPair, mainCfg.deviceParallelOps, mainCfg.deviceParallelWrites, outFp);
 
     for (const LocalPairConfig& lpc : mainCfg.additionalPairs)
-        writeConfig(lpc, mainCfg.deviceParallelOps, outFp);
+        writeConfig(lpc, mainCfg.deviceParallelOps, mainCfg.deviceParallelWrites, outFp);
 
     outMain["Errors"].attribute("Ignore", mainCfg.ignoreErrors);
     outMain["Errors"].attribute("Retry",  mainCfg.automaticRetryCount);
@@ -2039,7 +2078,12 @@ void writeConfig(const XmlGlobalSettings& cfg, XmlOut& out)
     outGeneral["FailSafeFileCopy"         ].attribute("Enabled", cfg.failSafeFileCopy);
     outGeneral["CopyLockedFiles"          ].attribute("Enabled", cfg.copyLockedFiles);
     outGeneral["CopyFilePermissions"      ].attribute("Enabled", cfg.copyFilePermissions);
+    outGeneral["StripedFileCopy"          ].attribute("MinSizeMB", cfg.stripedCopyMinSizeMB);
+    outGeneral["StreamingIO"              ].attribute("BlockSizeKB",   cfg.streamingIO.blockSize / 1024);
+    outGeneral["StreamingIO"              ].attribute("DropPageCache", cfg.streamingIO.dropPageCache);
+    outGeneral["StreamingIO"              ].attribute("DirectIO",      cfg.streamingIO.directIO);
     outGeneral["FileTimeTolerance"        ].attribute("Seconds", cfg.fileTimeTolerance);
+    outGeneral["CacheContentHashes"       ].attribute("Enabled", cfg.cacheContentHashes);
     outGeneral["RunWithBackgroundPriority"].attribute("Enabled", cfg.runWithBackgroundPriority);
     outGeneral["LockDirectoriesDuringSync"].attribute("Enabled", cfg.createLockFile);
     outGeneral["VerifyCopiedFiles"        ].attribute("Enabled", cfg.verifyFileCopy);
@@ -8,6 +8,7 @@
 #define PROCESS_XML_H_28345825704254262435
 
 #include <wx/gdicmn.h>
+#include <zen/file_io.h>
 #include "localization.h"
 #include "structures.h"
 #include "../ui/file_grid_attr.h"
@@ -174,8 +175,11 @@ struct XmlGlobalSettings
     bool failSafeFileCopy = true;
     bool copyLockedFiles  = false; //safer default: avoid copies of partially written files
     bool copyFilePermissions = false;
+    int stripedCopyMinSizeMB = 0; //copy large files as disjoint byte ranges, one per parallel operation; <= 0 := disabled
+    zen::IOProfile streamingIO; //local folders: bypass page cache for huge backups
 
     int fileTimeTolerance = 2; //max. allowed file time deviation; < 0 means unlimited tolerance; default 2s: FAT vs NTFS
+    bool cacheContentHashes = false; //compare by content: keep sync.ffs_hash per base folder
     bool runWithBackgroundPriority = false;
     bool createLockFile = true;
     bool verifyFileCopy = false;
@@ -47,6 +47,7 @@ public:
     //blocking call: context of worker thread
     //=> indirect support for "pause": reportInfo() is called under singleThread lock,
     //   so all other worker threads will wait when coming out of parallel I/O (trying to lock singleThread)
+    //   sync worker threads (no singleThread lock): wait on their next reportInfo() while the main thread is busy with the previous request
     void reportInfo(const std::wstring& msg) //throw ThreadInterruption
     {
         reportStatus(msg); //throw ThreadInterruption
@@ -493,6 +494,16 @@ auto parallelScope(Function&& fun, std::mutex& singleThread) //throw X
 
     return fun(); //throw X
 }
+
+
+template <class Function> inline
+auto parallelScope(Function&& fun, std::unique_lock<std::mutex>& itemLock) //throw X
+{
+    itemLock.unlock();
+    ZEN_ON_SCOPE_EXIT(itemLock.lock());
+
+    return fun(); //throw X
+}
 }
 
 #endif //STATUS_HANDLER_IMPL_H_07682758976
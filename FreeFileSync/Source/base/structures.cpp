@@ -258,6 +258,16 @@ void fff::setDeviceParallelOps(std::map<AfsDevice, size_t>& deviceParallelOps, c
 }
 
 
+size_t fff::getDeviceParallelWrites(const std::map<AfsDevice, size_t>& deviceParallelWrites, const std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice)
+{
+    auto it = deviceParallelWrites.find(afsDevice);
+    if (it != deviceParallelWrites.end())
+        return std::max<size_t>(it->second, 1);
+
+    return getDeviceParallelOps(deviceParallelOps, afsDevice);
+}
+
+
 std::wstring fff::getSymbol(CompareFilesResult cmpRes)
 {
     switch (cmpRes)
@@ -604,6 +614,11 @@ MainConfiguration fff::merge(const std::vector<MainConfiguration>& mainCfgs)
         for (const auto& [rootPath, parallelOps] : mainCfg.deviceParallelOps)
             mergedParallelOps[rootPath] = std::max(mergedParallelOps[rootPath], parallelOps);
 
+    std::map<AfsDevice, size_t> mergedParallelWrites;
+    for (const MainConfiguration& mainCfg : mainCfgs)
+        for (const auto& [rootPath, parallelWrites] : mainCfg.deviceParallelWrites)
+            mergedParallelWrites[rootPath] = std::max(mergedParallelWrites[rootPath], parallelWrites);
+
     //final assembly
     MainConfiguration cfgOut;
     cfgOut.cmpCfg       = cmpCfgHead;
@@ -612,6 +627,7 @@ MainConfiguration fff::merge(const std::vector<MainConfiguration>& mainCfgs)
     cfgOut.firstPair    = mergedCfgs[0];
     cfgOut.additionalPairs.assign(mergedCfgs.begin() + 1, mergedCfgs.end());
     cfgOut.deviceParallelOps = mergedParallelOps;
+    cfgOut.deviceParallelWrites = mergedParallelWrites;
 
     cfgOut.ignoreErrors = std::all_of(mainCfgs.begin(), mainCfgs.end(), [](const MainConfiguration& mainCfg) { return mainCfg.ignoreErrors; });
 
@@ -405,6 +405,7 @@ struct MainConfiguration
     std::vector<LocalPairConfig> additionalPairs;
 
     std::map<AfsDevice, size_t /*parallel operations*/> deviceParallelOps; //should only include devices with >= 2  parallel ops
+    std::map<AfsDevice, size_t /*parallel writes*/> deviceParallelWrites;  //explicit write limit during sync (e.g. slow target disk); not included: use deviceParallelOps
 
     bool ignoreErrors = false; //true: errors will still be logged
     size_t automaticRetryCount = 0;
@@ -424,6 +425,8 @@ void   setDeviceParallelOps(      std::map<AfsDevice, size_t>& deviceParallelOps
 size_t getDeviceParallelOps(const std::map<AfsDevice, size_t>& deviceParallelOps, const Zstring& folderPathPhrase);
 void   setDeviceParallelOps(      std::map<AfsDevice, size_t>& deviceParallelOps, const Zstring& folderPathPhrase, size_t parallelOps);
 
+size_t getDeviceParallelWrites(const std::map<AfsDevice, size_t>& deviceParallelWrites, const std::map<AfsDevice, size_t>& deviceParallelOps, const AfsDevice& afsDevice);
+
 inline
 bool operator==(const MainConfiguration& lhs, const MainConfiguration& rhs)
 {
@@ -433,6 +436,7 @@ bool operator==(const MainConfiguration& lhs, const MainConfiguration& rhs)
            lhs.firstPair           == rhs.firstPair           &&
            lhs.additionalPairs     == rhs.additionalPairs     &&
            lhs.deviceParallelOps   == rhs.deviceParallelOps   &&
+           lhs.deviceParallelWrites == rhs.deviceParallelWrites &&
            lhs.ignoreErrors        == rhs.ignoreErrors        &&
            lhs.automaticRetryCount == rhs.automaticRetryCount &&
            lhs.automaticRetryDelay == rhs.automaticRetryDelay &&
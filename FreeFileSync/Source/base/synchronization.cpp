@@ -6,6 +6,7 @@
 
 #include "synchronization.h"
 #include <tuple>
+#include <deque>
 #include <zen/process_priority.h>
 #include <zen/perf.h>
 #include <zen/guid.h>
@@ -473,105 +474,6 @@ void verifyFiles(const AbstractPath& sourcePath, const AbstractPath& targetPath,
 //#################################################################################################################
 //#################################################################################################################
 
-/* ________________________________________________________________
-   |                                                              |
-   | Multithreaded File Copy: Parallel API for expensive file I/O |
-   |______________________________________________________________| */
-
-namespace parallel
-{
-inline
-AFS::ItemType getItemType(const AbstractPath& ap, std::mutex& singleThread) //throw FileError
-{ return parallelScope([ap] { return AFS::getItemType(ap); /*throw FileError*/ }, singleThread); }
-
-inline
-std::optional<AFS::ItemType> itemStillExists(const AbstractPath& ap, std::mutex& singleThread) //throw FileError
-{ return parallelScope([ap] { return AFS::itemStillExists(ap); /*throw FileError*/ }, singleThread); }
-
-inline
-bool removeFileIfExists(const AbstractPath& ap, std::mutex& singleThread) //throw FileError
-{ return parallelScope([ap] { return AFS::removeFileIfExists(ap); /*throw FileError*/ }, singleThread); }
-
-inline
-bool removeSymlinkIfExists(const AbstractPath& ap, std::mutex& singleThread) //throw FileError
-{ return parallelScope([ap] { return AFS::removeSymlinkIfExists(ap); /*throw FileError*/ }, singleThread); }
-
-inline
-void moveAndRenameItem(const AbstractPath& apSource, const AbstractPath& apTarget, std::mutex& singleThread) //throw FileError, ErrorDifferentVolume
-{ parallelScope([apSource, apTarget] { AFS::moveAndRenameItem(apSource, apTarget); /*throw FileError, ErrorDifferentVolume*/ }, singleThread); }
-
-inline
-AbstractPath getSymlinkResolvedPath(const AbstractPath& ap, std::mutex& singleThread) //throw FileError
-{ return parallelScope([ap] { return AFS::getSymlinkResolvedPath(ap); /*throw FileError*/ }, singleThread); }
-
-inline
-void copySymlink(const AbstractPath& apSource, const AbstractPath& apTarget, bool copyFilePermissions, std::mutex& singleThread) //throw FileError
-{ parallelScope([apSource, apTarget, copyFilePermissions] { AFS::copySymlink(apSource, apTarget, copyFilePermissions); /*throw FileError*/ }, singleThread); }
-
-inline
-void copyNewFolder(const AbstractPath& apSource, const AbstractPath& apTarget, bool copyFilePermissions, std::mutex& singleThread) //throw FileError
-{ parallelScope([apSource, apTarget, copyFilePermissions] { AFS::copyNewFolder(apSource, apTarget, copyFilePermissions); /*throw FileError*/ }, singleThread); }
-
-inline
-void removeFilePlain(const AbstractPath& ap, std::mutex& singleThread) //throw FileError
-{ parallelScope([ap] { AFS::removeFilePlain(ap); /*throw FileError*/ }, singleThread); }
-
-//--------------------------------------------------------------
-//ATTENTION CALLBACKS: they also run asynchronously *outside* the singleThread lock!
-//--------------------------------------------------------------
-inline
-void removeFolderIfExistsRecursion(const AbstractPath& ap, //throw FileError
-                                   const std::function<void (const std::wstring& displayPath)>& onBeforeFileDeletion, //optional
-                                   const std::function<void (const std::wstring& displayPath)>& onBeforeFolderDeletion, //one call for each object!
-                                   std::mutex& singleThread)
-{ parallelScope([ap, onBeforeFileDeletion, onBeforeFolderDeletion] { AFS::removeFolderIfExistsRecursion(ap, onBeforeFileDeletion, onBeforeFolderDeletion); /*throw FileError*/ }, singleThread); }
-
-
-inline
-AFS::FileCopyResult copyFileTransactional(const AbstractPath& apSource, const AFS::StreamAttributes& attrSource, //throw FileError, ErrorFileLocked, X
-                                          const AbstractPath& apTarget,
-                                          bool copyFilePermissions,
-                                          bool transactionalCopy,
-                                          const std::function<void()>& onDeleteTargetFile /*throw X*/,
-                                          const IOCallback& notifyUnbufferedIO /*throw X*/,
-                                          std::mutex& singleThread)
-{
-    return parallelScope([=]
-    {
-        return AFS::copyFileTransactional(apSource, attrSource, apTarget, copyFilePermissions, transactionalCopy, onDeleteTargetFile, notifyUnbufferedIO); //throw FileError, ErrorFileLocked, X
-    }, singleThread);
-}
-
-inline //RecycleSession::recycleItemIfExists() is internally synchronized!
-void recycleItemIfExists(AFS::RecycleSession& recyclerSession, const AbstractPath& ap, const Zstring& logicalRelPath, std::mutex& singleThread) //throw FileError
-{ parallelScope([=, &recyclerSession] { return recyclerSession.recycleItemIfExists(ap, logicalRelPath); /*throw FileError*/ }, singleThread); }
-
-inline //FileVersioner::revisionFile() is internally synchronized!
-void revisionFile(FileVersioner& versioner, const FileDescriptor& fileDescr, const Zstring& relativePath, const IOCallback& notifyUnbufferedIO /*throw X*/, std::mutex& singleThread) //throw FileError, X
-{ parallelScope([=, &versioner] { return versioner.revisionFile(fileDescr, relativePath, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
-
-inline //FileVersioner::revisionSymlink() is internally synchronized!
-void revisionSymlink(FileVersioner& versioner, const AbstractPath& linkPath, const Zstring& relativePath, std::mutex& singleThread) //throw FileError
-{ parallelScope([=, &versioner] { return versioner.revisionSymlink(linkPath, relativePath); /*throw FileError*/ }, singleThread); }
-
-inline //FileVersioner::revisionFolder() is internally synchronized!
-void revisionFolder(FileVersioner& versioner,
-                    const AbstractPath& folderPath, const Zstring& relativePath,
-                    const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFileMove    /*throw X*/,
-                    const std::function<void(const std::wstring& displayPathFrom, const std::wstring& displayPathTo)>& onBeforeFolderMove  /*throw X*/,
-                    const IOCallback& notifyUnbufferedIO  /*throw X*/,
-                    std::mutex& singleThread) //throw FileError, X
-{ parallelScope([=, &versioner] { versioner.revisionFolder(folderPath, relativePath, onBeforeFileMove, onBeforeFolderMove, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
-
-inline
-void verifyFiles(const AbstractPath& apSource, const AbstractPath& apTarget, const IOCallback& notifyUnbufferedIO /*throw X*/, std::mutex& singleThread) //throw FileError, X
-{ parallelScope([=] { ::verifyFiles(apSource, apTarget, notifyUnbufferedIO); /*throw FileError, X*/ }, singleThread); }
-
-}
-
-//#################################################################################################################
-//#################################################################################################################
-
 class DeletionHandler //abstract deletion variants: permanently, recycle bin, user-defined directory
 {
 public:
@@ -584,9 +486,10 @@ public:
     //clean-up temporary directory (recycle bin optimization)
     void tryCleanup(ProcessCallback& cb /*throw X*/, bool allowCallbackException); //throw FileError -> call this in non-exceptional code path, i.e. somewhere after sync!
 
-    void removeDirWithCallback (const AbstractPath&   dirPath,   const Zstring& relativePath, AsyncItemStatReporter& statReporter, std::mutex& singleThread); //
-    void removeFileWithCallback(const FileDescriptor& fileDescr, const Zstring& relativePath, AsyncItemStatReporter& statReporter, std::mutex& singleThread); //throw FileError, ThreadInterruption
-    void removeLinkWithCallback(const AbstractPath&   linkPath,  const Zstring& relativePath, AsyncItemStatReporter& statReporter, std::mutex& singleThread); //
+    //thread-safe: called by sync worker threads in parallel
+    void removeDirWithCallback (const AbstractPath&   dirPath,   const Zstring& relativePath, AsyncItemStatReporter& statReporter); //
+    void removeFileWithCallback(const FileDescriptor& fileDescr, const Zstring& relativePath, AsyncItemStatReporter& statReporter); //throw FileError, ThreadInterruption
+    void removeLinkWithCallback(const AbstractPath&   linkPath,  const Zstring& relativePath, AsyncItemStatReporter& statReporter); //
 
     const std::wstring& getTxtRemovingFile   () const { return txtRemovingFile_;    } //
     const std::wstring& getTxtRemovingFolder () const { return txtRemovingFolder_;  } //buffered status texts
@@ -599,6 +502,7 @@ private:
     AFS::RecycleSession& getOrCreateRecyclerSession() //throw FileError => dont create in constructor!!!
     {
         assert(deletionPolicy_ == DeletionPolicy::RECYCLER);
+        std::lock_guard dummy(lockSessionInit_);
         if (!recyclerSession_)
             recyclerSession_ =  AFS::createRecyclerSession(baseFolderPath_); //throw FileError
         return *recyclerSession_;
@@ -607,6 +511,7 @@ private:
     FileVersioner& getOrCreateVersioner() //throw FileError => dont create in constructor!!!
     {
         assert(deletionPolicy_ == DeletionPolicy::VERSIONING);
+        std::lock_guard dummy(lockSessionInit_);
         if (!versioner_)
             versioner_ = std::make_unique<FileVersioner>(versioningFolderPath_, versioningStyle_, syncStartTime_); //throw FileError
         return *versioner_;
@@ -623,6 +528,8 @@ private:
     const time_t syncStartTime_;
     std::unique_ptr<FileVersioner> versioner_;
 
+    std::mutex lockSessionInit_; //RecycleSession and FileVersioner are internally synchronized, but their one-time construction is not!
+
     //buffer status texts:
     const std::wstring txtRemovingFile_;
     const std::wstring txtRemovingSymlink_;
@@ -721,13 +628,12 @@ void DeletionHandler::tryCleanup(ProcessCallback& cb /*throw X*/, bool allowCall
 
 void DeletionHandler::removeDirWithCallback(const AbstractPath& folderPath,//throw FileError, ThreadInterruption
                                             const Zstring& relativePath,
-                                            AsyncItemStatReporter& statReporter, std::mutex& singleThread)
+                                            AsyncItemStatReporter& statReporter)
 {
     switch (deletionPolicy_)
     {
         case DeletionPolicy::PERMANENT:
         {
-            //callbacks run *outside* singleThread_ lock! => fine
             auto notifyDeletion = [&statReporter](const std::wstring& statusText, const std::wstring& displayPath)
             {
                 statReporter.reportStatus(replaceCpy(statusText, L"%x", fmtPath(displayPath))); //throw ThreadInterruption
@@ -739,18 +645,17 @@ void DeletionHandler::removeDirWithCallback(const AbstractPath& folderPath,//thr
             auto onBeforeFileDeletion = [&](const std::wstring& displayPath) { notifyDeletion(txtRemovingFile_,   displayPath); };
             auto onBeforeDirDeletion  = [&](const std::wstring& displayPath) { notifyDeletion(txtRemovingFolder_, displayPath); };
 
-            parallel::removeFolderIfExistsRecursion(folderPath, onBeforeFileDeletion, onBeforeDirDeletion, singleThread); //throw FileError
+            AFS::removeFolderIfExistsRecursion(folderPath, onBeforeFileDeletion, onBeforeDirDeletion); //throw FileError
         }
         break;
 
         case DeletionPolicy::RECYCLER:
-            parallel::recycleItemIfExists(getOrCreateRecyclerSession(), folderPath, relativePath, singleThread); //throw FileError
+            getOrCreateRecyclerSession().recycleItemIfExists(folderPath, relativePath); //throw FileError
             statReporter.reportDelta(1, 0); //moving to recycler is ONE logical operation, irrespective of the number of child elements!
             break;
 
         case DeletionPolicy::VERSIONING:
         {
-            //callbacks run *outside* singleThread_ lock! => fine
             auto notifyMove = [&statReporter](const std::wstring& statusText, const std::wstring& displayPathFrom, const std::wstring& displayPathTo)
             {
                 statReporter.reportStatus(replaceCpy(replaceCpy(statusText, L"%x", L"\n" + fmtPath(displayPathFrom)), L"%y", L"\n" + fmtPath(displayPathTo))); //throw ThreadInterruption
@@ -762,7 +667,7 @@ void DeletionHandler::removeDirWithCallback(const AbstractPath& folderPath,//thr
             auto onBeforeFolderMove = [&](const std::wstring& displayPathFrom, const std::wstring& displayPathTo) { notifyMove(txtMovingFolderXtoY_, displayPathFrom, displayPathTo); };
             auto notifyUnbufferedIO = [&](int64_t bytesDelta) { statReporter.reportDelta(0, bytesDelta); interruptionPoint(); }; //throw ThreadInterruption
 
-            parallel::revisionFolder(getOrCreateVersioner(), folderPath, relativePath, onBeforeFileMove, onBeforeFolderMove, notifyUnbufferedIO, singleThread); //throw FileError, ThreadInterruption
+            getOrCreateVersioner().revisionFolder(folderPath, relativePath, onBeforeFileMove, onBeforeFolderMove, notifyUnbufferedIO); //throw FileError, ThreadInterruption
         }
         break;
     }
@@ -771,26 +676,25 @@ void DeletionHandler::removeDirWithCallback(const AbstractPath& folderPath,//thr
 
 void DeletionHandler::removeFileWithCallback(const FileDescriptor& fileDescr, //throw FileError, ThreadInterruption
                                              const Zstring& relativePath,
-                                             AsyncItemStatReporter& statReporter, std::mutex& singleThread)
+                                             AsyncItemStatReporter& statReporter)
 {
 
     if (endsWith(relativePath, AFS::TEMP_FILE_ENDING)) //special rule for .ffs_tmp files: always delete permanently!
-        parallel::removeFileIfExists(fileDescr.path, singleThread); //throw FileError
+        AFS::removeFileIfExists(fileDescr.path); //throw FileError
     else
         switch (deletionPolicy_)
         {
             case DeletionPolicy::PERMANENT:
-                parallel::removeFileIfExists(fileDescr.path, singleThread); //throw FileError
+                AFS::removeFileIfExists(fileDescr.path); //throw FileError
                 break;
             case DeletionPolicy::RECYCLER:
-                parallel::recycleItemIfExists(getOrCreateRecyclerSession(), fileDescr.path, relativePath, singleThread); //throw FileError
+                getOrCreateRecyclerSession().recycleItemIfExists(fileDescr.path, relativePath); //throw FileError
                 break;
             case DeletionPolicy::VERSIONING:
             {
-                //callback runs *outside* singleThread_ lock! => fine
                 auto notifyUnbufferedIO = [&](int64_t bytesDelta) { statReporter.reportDelta(0, bytesDelta); interruptionPoint(); }; //throw ThreadInterruption
 
-                parallel::revisionFile(getOrCreateVersioner(), fileDescr, relativePath, notifyUnbufferedIO, singleThread); //throw FileError, ThreadInterruption
+                getOrCreateVersioner().revisionFile(fileDescr, relativePath, notifyUnbufferedIO); //throw FileError, ThreadInterruption
             }
             break;
         }
@@ -803,18 +707,18 @@ void DeletionHandler::removeFileWithCallback(const FileDescriptor& fileDescr, //
 
 void DeletionHandler::removeLinkWithCallback(const AbstractPath& linkPath, //throw FileError, throw ThreadInterruption
                                              const Zstring& relativePath,
-                                             AsyncItemStatReporter& statReporter, std::mutex& singleThread)
+                                             AsyncItemStatReporter& statReporter)
 {
     switch (deletionPolicy_)
     {
         case DeletionPolicy::PERMANENT:
-            parallel::removeSymlinkIfExists(linkPath, singleThread); //throw FileError
+            AFS::removeSymlinkIfExists(linkPath); //throw FileError
             break;
         case DeletionPolicy::RECYCLER:
-            parallel::recycleItemIfExists(getOrCreateRecyclerSession(), linkPath, relativePath, singleThread); //throw FileError
+            getOrCreateRecyclerSession().recycleItemIfExists(linkPath, relativePath); //throw FileError
             break;
         case DeletionPolicy::VERSIONING:
-            parallel::revisionSymlink(getOrCreateVersioner(), linkPath, relativePath, singleThread); //throw FileError
+            getOrCreateVersioner().revisionSymlink(linkPath, relativePath); //throw FileError
             break;
     }
     //remain transactional as much as possible => no more callbacks that can throw after successful deletion! (next: update file model!)
@@ -826,27 +730,170 @@ void DeletionHandler::removeLinkWithCallback(const AbstractPath& linkPath, //thr
 //===================================================================================================
 //===================================================================================================
 
+//admission control for sync I/O: shared by all folder pairs
+//separate read and write budgets per device (e.g. fast source, slow archive target): reads limited by deviceParallelOps, writes by deviceParallelWrites
+class DeviceIoLimiter
+{
+public:
+    DeviceIoLimiter(const std::map<AfsDevice, size_t>& deviceParallelOps,
+                    const std::map<AfsDevice, size_t>& deviceParallelWrites) :
+        deviceParallelOps_(deviceParallelOps),
+        deviceParallelWrites_(deviceParallelWrites) {}
+
+    //blocking call: context of worker thread
+    void acquire(const std::optional<AfsDevice>& deviceRead, const AfsDevice& deviceWrite, AsyncCallback& acb) //throw ThreadInterruption
+    {
+        //read before write: ops holding a write slot never wait => no deadlock
+        if (deviceRead)
+            acquireSlot(*deviceRead, IoType::READ, acb); //throw ThreadInterruption
+        ZEN_ON_SCOPE_FAIL(if (deviceRead) releaseSlot(*deviceRead, IoType::READ));
+
+        acquireSlot(deviceWrite, IoType::WRITE, acb); //throw ThreadInterruption
+    }
+
+    void release(const std::optional<AfsDevice>& deviceRead, const AfsDevice& deviceWrite) //noexcept
+    {
+        releaseSlot(deviceWrite, IoType::WRITE);
+        if (deviceRead)
+            releaseSlot(*deviceRead, IoType::READ);
+    }
+
+    size_t getParallelWrites(const AfsDevice& device) const { return getDeviceParallelWrites(deviceParallelWrites_, deviceParallelOps_, device); }
+
+    //non-blocking: additional write slots for the parallel stripes of a single file copy; return number of slots acquired
+    size_t tryAcquireWrites(const AfsDevice& device, size_t countMax) //noexcept
+    {
+        const size_t parallelWrites = getParallelWrites(device);
+
+        std::lock_guard dummy(lockSlots_);
+        IoSlots& slots = ioSlots_[device][IoType::WRITE];
+
+        if (slots.queued > 0 || slots.active >= parallelWrites) //waiting operations go first
+            return 0;
+
+        const size_t count = std::min(countMax, parallelWrites - slots.active);
+        slots.active += count;
+        return count;
+    }
+
+    void releaseWrites(const AfsDevice& device, size_t count) //noexcept
+    {
+        if (count == 0)
+            return;
+        {
+            std::lock_guard dummy(lockSlots_);
+            IoSlots& slots = ioSlots_[device][IoType::WRITE];
+            assert(slots.active >= count);
+            slots.active -= count;
+        }
+        conditionSlotFree_.notify_all();
+    }
+
+private:
+    DeviceIoLimiter           (const DeviceIoLimiter&) = delete;
+    DeviceIoLimiter& operator=(const DeviceIoLimiter&) = delete;
+
+    enum IoType
+    {
+        READ,
+        WRITE,
+    };
+
+    struct IoSlots
+    {
+        size_t active = 0;
+        size_t queued = 0;
+    };
+
+    void acquireSlot(const AfsDevice& device, IoType ioType, AsyncCallback& acb) //throw ThreadInterruption
+    {
+        const size_t parallelOps = ioType == IoType::READ ?
+                                   getDeviceParallelOps   (deviceParallelOps_, device) :
+                                   getDeviceParallelWrites(deviceParallelWrites_, deviceParallelOps_, device);
+
+        std::unique_lock dummy(lockSlots_);
+        IoSlots& slots = ioSlots_[device][ioType];
+
+        if (slots.active >= parallelOps)
+        {
+            ++slots.queued;
+            ZEN_ON_SCOPE_EXIT(--slots.queued);
+
+            //live stats: status of waiting thread
+            const std::wstring statusMsg = (ioType == IoType::READ ? _("Waiting for read access:") : _("Waiting for write access:")) + L" " +
+                                           fmtPath(AFS::getDisplayPath(AbstractPath(device, AfsPath()))) +
+                                           L" [" + _P("1 operation queued", "%x operations queued", slots.queued) + L"]";
+            {
+                dummy.unlock();
+                ZEN_ON_SCOPE_EXIT(dummy.lock()); //re-lock *before* "--slots.queued", even on ThreadInterruption
+                acb.reportStatus(statusMsg); //throw ThreadInterruption
+            }
+
+            interruptibleWait(conditionSlotFree_, dummy, [&] { return slots.active < parallelOps; }); //throw ThreadInterruption
+        }
+        ++slots.active;
+    }
+
+    void releaseSlot(const AfsDevice& device, IoType ioType) //noexcept
+    {
+        {
+            std::lock_guard dummy(lockSlots_);
+            IoSlots& slots = ioSlots_[device][ioType];
+            assert(slots.active > 0);
+            --slots.active;
+        }
+        conditionSlotFree_.notify_all();
+    }
+
+    const std::map<AfsDevice, size_t>& deviceParallelOps_;
+    const std::map<AfsDevice, size_t>& deviceParallelWrites_;
+
+    std::mutex lockSlots_;
+    std::condition_variable conditionSlotFree_;
+    std::map<AfsDevice, std::array<IoSlots, 2>> ioSlots_; //[IoType]
+};
+
+//===================================================================================================
+
+template <class WorkItem> //trivially copyable; with members "uint64_t bytes" (scheduling hint) and "bool batchable"
 class Workload
 {
 public:
-    Workload(size_t threadCount, AsyncCallback& acb) : acb_(acb), workload_(threadCount) { assert(threadCount > 0); }
+    explicit Workload(size_t threadCount) : workload_(threadCount) { assert(threadCount > 0); }
 
-    using WorkItem  = std::function<void() /*throw ThreadInterruption*/>;
     using WorkItems = RingBuffer<WorkItem>; //FIFO!
 
     //blocking call: context of worker thread
-    WorkItem getNext(size_t threadIdx) //throw ThreadInterruption
+    void getNext(size_t threadIdx, std::vector<WorkItem>& batch) //throw ThreadInterruption
     {
         interruptionPoint(); //throw ThreadInterruption
 
+        batch.clear();
+
         std::unique_lock dummy(lockWork_);
         for (;;)
         {
+            if (!largeItems_.empty()) //start large items first: don't have them be the last ones running
+            {
+                std::pop_heap(largeItems_.begin(), largeItems_.end(), lessBytes);
+                batch.push_back(largeItems_.back());
+                /**/            largeItems_.pop_back();
+                return;
+            }
             if (!workload_[threadIdx].empty())
             {
-                auto wi = std::move(workload_[threadIdx].    front());
-                /**/                workload_[threadIdx].pop_front();
-                return wi;
+                WorkItems& items = workload_[threadIdx];
+                uint64_t batchBytes = 0;
+                do //batch runs of small items: one lock acquisition and status task per batch
+                {
+                    batchBytes += items.front().bytes;
+                    batch.push_back(items.    front());
+                    /**/            items.pop_front();
+                }
+                while (!items.empty() && batch.size() < BATCH_ITEMS_MAX &&
+                       batch.front().batchable && items.front().batchable &&
+                       batchBytes + items.front().bytes <= BATCH_BYTES_MAX);
+                return;
             }
             if (!pendingWorkload_.empty())
             {
@@ -863,21 +910,21 @@ public:
                     const size_t sz = items.size(); //[!] variable during loop!
                     for (size_t i = 0; i < sz; ++i)
                     {
-                        auto wi = std::move(items.    front());
+                        const WorkItem wi = items.front();
                         /**/                items.pop_front();
                         if (i % 2 == 0)
-                            workload_[threadIdx].push_back(std::move(wi));
+                            workload_[threadIdx].push_back(wi);
                         else
-                            items.push_back(std::move(wi));
+                            items.push_back(wi);
                     }
                 }
                 else //wait...
                 {
                     if (++idleThreads_ == workload_.size())
-                        acb_.notifyAllDone(); //noexcept
+                        conditionAllIdle_.notify_all(); //all threads idle => no more work can be added
                     ZEN_ON_SCOPE_EXIT(--idleThreads_);
 
-                    auto haveNewWork = [&] { return !pendingWorkload_.empty() || std::any_of(workload_.begin(), workload_.end(), [](const WorkItems& wi) { return !wi.empty(); }); };
+                    auto haveNewWork = [&] { return !largeItems_.empty() || !pendingWorkload_.empty() || std::any_of(workload_.begin(), workload_.end(), [](const WorkItems& wi) { return !wi.empty(); }); };
 
                     interruptibleWait(conditionNewWork_, dummy, [&] { return haveNewWork(); }); //throw ThreadInterruption
                     //it's sufficient to notify condition in addWorkItems() only (as long as we use std::condition_variable::notify_all())
@@ -892,26 +939,57 @@ public:
             std::lock_guard dummy(lockWork_);
             while (!buckets.empty())
             {
-                pendingWorkload_.push_back(std::move(buckets.    front()));
-                /**/                                 buckets.pop_front();
+                WorkItems& items = buckets.front();
+
+                const size_t sz = items.size(); //[!] variable during loop!
+                for (size_t i = 0; i < sz; ++i)
+                {
+                    const WorkItem wi = items.front();
+                    /**/                items.pop_front();
+                    if (wi.bytes >= LARGE_ITEM_BYTES)
+                    {
+                        largeItems_.push_back(wi);
+                        std::push_heap(largeItems_.begin(), largeItems_.end(), lessBytes);
+                    }
+                    else
+                        items.push_back(wi);
+                }
+
+                if (!items.empty())
+                    pendingWorkload_.push_back(std::move(items));
+                buckets.pop_front();
             }
         }
         conditionNewWork_.notify_all();
     }
 
+    //blocking call: context of folder pair thread
+    void waitUntilDone() //throw ThreadInterruption
+    {
+        std::unique_lock dummy(lockWork_);
+        interruptibleWait(conditionAllIdle_, dummy, [&] { return idleThreads_ == workload_.size(); }); //throw ThreadInterruption
+    }
+
+    static constexpr size_t BATCH_ITEMS_MAX = 32;
+
 private:
     Workload           (const Workload&) = delete;
     Workload& operator=(const Workload&) = delete;
 
-    AsyncCallback& acb_;
+    static bool lessBytes(const WorkItem& lhs, const WorkItem& rhs) { return lhs.bytes < rhs.bytes; }
+
+    static constexpr uint64_t LARGE_ITEM_BYTES = 64 * 1024 * 1024;
+    static constexpr uint64_t BATCH_BYTES_MAX  =      1024 * 1024;
 
     std::mutex lockWork_;
     std::condition_variable conditionNewWork_;
+    std::condition_variable conditionAllIdle_;
 
     size_t idleThreads_ = 0;
 
     std::vector<WorkItems> workload_; //thread-specific buckets
     RingBuffer<WorkItems> pendingWorkload_; //FIFO: buckets of work items for use by any thread
+    std::vector<WorkItem> largeItems_; //max-heap by bytes: served before all buckets
 };
 
 
@@ -923,21 +1001,23 @@ public:
         bool verifyCopiedFiles;
         bool copyFilePermissions;
         bool failSafeFileCopy;
-        std::vector<FileError>& errorsModTime;
+        uint64_t stripedCopyMinSize; //0: disabled
+        Protected<std::vector<FileError>>& errorsModTime;
+        std::mutex& lockHierarchy; //shared by all folder pairs
+        DeviceIoLimiter& ioLimiter;    //
         DeletionHandler& delHandlerLeft;
         DeletionHandler& delHandlerRight;
         size_t threadCount;
     };
 
-    static void runSync(SyncCtx& syncCtx, BaseFolderPair& baseFolder, ProcessCallback& cb)
+    //context of folder pair thread: runs in parallel with other folder pairs
+    static void runSync(SyncCtx& syncCtx, BaseFolderPair& baseFolder, AsyncCallback& acb, size_t statusPrio) //throw ThreadInterruption
     {
-        runPass(PASS_ZERO, syncCtx, baseFolder, cb); //prepare file moves
-        runPass(PASS_ONE,  syncCtx, baseFolder, cb); //delete files (or overwrite big ones with smaller ones)
-        runPass(PASS_TWO,  syncCtx, baseFolder, cb); //copy rest
+        runPass(PASS_ZERO, syncCtx, baseFolder, acb, statusPrio); //prepare file moves
+        runPass(PASS_ONE,  syncCtx, baseFolder, acb, statusPrio); //delete files (or overwrite big ones with smaller ones) + copy rest: PASS_TWO items wait for their dependencies only
     }
 
 private:
-    friend class Workload;
     enum PassNo
     {
         PASS_ZERO, //prepare file moves
@@ -946,24 +1026,96 @@ private:
         PASS_NEVER //skip item
     };
 
-    FolderPairSyncer(SyncCtx& syncCtx, std::mutex& singleThread, AsyncCallback& acb) :
+    FolderPairSyncer(SyncCtx& syncCtx, AsyncCallback& acb) :
         errorsModTime_      (syncCtx.errorsModTime),
         delHandlerLeft_     (syncCtx.delHandlerLeft),
         delHandlerRight_    (syncCtx.delHandlerRight),
         verifyCopiedFiles_  (syncCtx.verifyCopiedFiles),
         copyFilePermissions_(syncCtx.copyFilePermissions),
         failSafeFileCopy_   (syncCtx.failSafeFileCopy),
-        singleThread_(singleThread),
+        stripedCopyMinSize_ (syncCtx.stripedCopyMinSize),
+        stripeCount_        (syncCtx.threadCount),
+        lockHierarchy_(syncCtx.lockHierarchy),
+        ioLimiter_(syncCtx.ioLimiter),
         acb_(acb) {}
 
+    //blocking call: acquire device I/O slots for the duration of a sync operation (read: source, write: target)
+    template <SelectedSide sideTrg>
+    void acquireDeviceIo(const FileSystemObject& fsObj, SyncOperation syncOp); //throw ThreadInterruption
+    template <SelectedSide sideTrg>
+    void releaseDeviceIo(const FileSystemObject& fsObj, SyncOperation syncOp); //noexcept
+
     static PassNo getPass(const FilePair&    file);
     static PassNo getPass(const SymlinkPair& link);
     static PassNo getPass(const FolderPair&  folder);
     static bool needZeroPass(const FilePair& file);
 
-    static void runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& baseFolder, ProcessCallback& cb); //throw X
+    //dependency graph of PASS_ONE and PASS_TWO items, one node per folder level:
+    // - PASS_TWO items wait for the PASS_ONE items of the same folder level: avoid name clashes and disk space shortage
+    // - PASS_TWO folder operation (create, rename) waits for all PASS_ONE items inside the folder
+    // - items inside a folder wait for its PASS_TWO folder operation
+    // - folder deletion (PASS_ONE) removes all sub items, see DeletionHandler::removeDirWithCallback()
+    //additional edge across all folder levels: file copies wait for PASS_ONE items freeing space on the same device, see SpaceRelease
+    struct FolderLevel
+    {
+        ContainerObject& hierObj;
+        const FileSystemObject::ObjectId folderId; //nullptr for base folder
+        FolderLevel* const parent;
+        bool folderOpDone; //false: PASS_TWO folder operation pending
+
+        std::vector<FolderLevel*> subLevels{};
+        size_t pendingDirect  = 0; //PASS_ONE items of this folder level
+        size_t pendingSubtree = 0; //pendingDirect + sub levels with PASS_ONE items pending
+        bool active          = false; //folder operations of this and all parent levels are done
+        bool passTwoReleased = false;
+    };
+
+    struct SpaceRelease; //per target device
 
-    RingBuffer<Workload::WorkItems> getFolderLevelWorkItems(PassNo pass, ContainerObject& parentFolder, Workload& workload);
+    enum class WorkType : unsigned char
+    {
+        PREPARE_FILE_MOVE,
+        PASS_ONE_FOLDER, //
+        PASS_ONE_FILE,   //level: folder level of the item
+        PASS_ONE_LINK,   //
+        PASS_TWO_FOLDER, //level: folder level *of the folder itself*
+        PASS_TWO_FILE,
+        PASS_TWO_LINK,
+    };
+
+    struct WorkItem //trivially copyable: no allocation per item (unlike std::function)
+    {
+        WorkType type;
+        bool batchable; //file and symlink items only: folder items may add new work => don't delay
+        FileSystemObject* fsObj;
+        FolderLevel* level;
+        uint64_t bytes; //scheduling hint: large items first
+        SpaceRelease* spaceRelease = nullptr; //PASS_ONE items freeing disk space
+    };
+    using SyncWorkload = Workload<WorkItem>;
+
+    struct SpaceRelease
+    {
+        size_t pending = 0; //PASS_ONE items freeing disk space: deletion, overwrite big with smaller file
+        SyncWorkload::WorkItems waiting; //PASS_TWO items allocating disk space: file creation, overwrite small with bigger file
+    };
+
+    static void runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& baseFolder, AsyncCallback& acb, size_t statusPrio); //throw ThreadInterruption
+
+    void runWorkItem(const WorkItem& wi, SyncWorkload& workload); //throw ThreadInterruption
+
+    RingBuffer<SyncWorkload::WorkItems> getPassZeroWorkItems  (ContainerObject& baseFolder);
+    RingBuffer<SyncWorkload::WorkItems> getPassOneTwoWorkItems(ContainerObject& baseFolder);
+
+    //call while holding "lockHierarchy":
+    FolderLevel& addFolderLevel(ContainerObject& hierObj, FolderPair* folder, FolderLevel* parentLevel, bool folderOpDone);
+    void addPassOneItems    (FolderLevel& startLevel, RingBuffer<SyncWorkload::WorkItems>& buckets);
+    void activateFolderLevel(FolderLevel& startLevel, RingBuffer<SyncWorkload::WorkItems>& buckets);
+    void addPassTwoItems    (FolderLevel& level,      RingBuffer<SyncWorkload::WorkItems>& buckets);
+
+    void notifyPassOneDone(const WorkItem& wi, SyncWorkload& workload);
+
+    SpaceRelease* getSpaceRelease(const FileSystemObject& fsObj); //nullptr if sync operation doesn't free or allocate disk space
 
     enum class CmtfStatus //CreateMoveTargetFolderStatus
     {
@@ -971,9 +1123,10 @@ private:
         NAME_CLASH,
         SOURCE_MISSING
     };
-    template <SelectedSide side> void setup2StepMove(FilePair& sourceFile, FilePair& targetFile); //throw FileError, ThreadInterruption
-    template <SelectedSide side> CmtfStatus createMoveTargetFolder(FileSystemObject& fsObj); //throw FileError, ThreadInterruption
-    template <SelectedSide side> void resolveMoveConflicts(FilePair& sourceFile, FilePair& targetFile); //throw FileError, ThreadInterruption
+    //0th pass: move pairs are scattered all over the hierarchy => call while holding "hierarchyLock"; unlocked during file I/O only
+    template <SelectedSide side> void setup2StepMove(FilePair& sourceFile, FilePair& targetFile, std::unique_lock<std::mutex>& hierarchyLock); //throw FileError, ThreadInterruption
+    template <SelectedSide side> CmtfStatus createMoveTargetFolder(FileSystemObject& fsObj,      std::unique_lock<std::mutex>& hierarchyLock); //throw FileError, ThreadInterruption
+    template <SelectedSide side> void resolveMoveConflicts(FilePair& sourceFile, FilePair& targetFile, std::unique_lock<std::mutex>& hierarchyLock); //throw FileError, ThreadInterruption
 
     void prepareFileMove(FilePair& file); //throw ThreadInterruption
 
@@ -997,7 +1150,7 @@ private:
                                              const AbstractPath& targetPath,
                                              const std::function<void()>& onDeleteTargetFile /*throw X*/, //optional!
                                              AsyncItemStatReporter& statReporter);
-    std::vector<FileError>& errorsModTime_;
+    Protected<std::vector<FileError>>& errorsModTime_;
 
     DeletionHandler& delHandlerLeft_;
     DeletionHandler& delHandlerRight_;
@@ -1005,8 +1158,13 @@ private:
     const bool verifyCopiedFiles_;
     const bool copyFilePermissions_;
     const bool failSafeFileCopy_;
+    const uint64_t stripedCopyMinSize_;
+    const size_t stripeCount_; //upper limit: further capped by target device's write budget
 
-    std::mutex& singleThread_;
+    std::mutex& lockHierarchy_; //protect file_hierarchy model (not thread-safe!) and folderLevels_
+    DeviceIoLimiter& ioLimiter_;
+    std::deque<FolderLevel> folderLevels_;
+    std::map<AfsDevice, SpaceRelease> spaceRelease_; //target device => PASS_ONE/PASS_TWO disk space dependency
     AsyncCallback& acb_;
 
     //preload status texts (premature?)
@@ -1039,100 +1197,366 @@ Callback     =============       --------------------
                                  |     Workload     |
                                  --------------------
 
-Notes: - All threads share a single mutex, unlocked only during file I/O => do NOT require file_hierarchy.cpp classes to be thread-safe (i.e. internally synchronized)!
+Notes: - Folder pairs run in parallel, each on its own thread running the passes with its own worker threads; all workers share a single Async Callback
+       - Folder pairs with dependent base folders (=> getPathDependency()) wait for each other, in configuration order; I/O per device is limited by DeviceIoLimiter
+       - Item ownership: a work item exclusively owns its FileSystemObject and the (not yet scheduled) sub-items => file I/O, status reporting and reading item attributes need no lock
+       - file_hierarchy.cpp classes are not thread-safe: updating the model (setSyncedTo(), removeObject(), sync operation buffer of parent folders) requires "lockHierarchy"
+       - Move pairs (0th pass and SO_MOVE_LEFT_TO/SO_MOVE_RIGHT_TO) reference items anywhere in the hierarchy => hold "lockHierarchy" except during file I/O
+       - No barrier between 1st and 2nd pass: PASS_TWO items are scheduled as soon as the PASS_ONE items they depend on are done (see FolderLevel)
+         file copies still wait for all PASS_ONE items freeing disk space on their target device (see SpaceRelease)
        - Workload holds (folder-level-) items in buckets associated with each worker thread (FTP scenario: avoid CWDs)
        - If a worker is idle, its Workload bucket is empty and no more pending buckets available: steal from other threads (=> take half of largest bucket)
        - Maximize opportunity for parallelization ASAP: Workload buckets serve folder-items *before* files/symlinks => reduce risk of work-stealing
+       - Large files are served before all buckets (largest first): avoid a single big file being the last one to start
+       - Runs of small files/symlinks are handed out as a batch: one lock acquisition and one status task per batch
        - Memory consumption: work items may grow indefinitely; however: test case "C:\" ~80MB per 1 million work items
 */
 
-void FolderPairSyncer::runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& baseFolder, ProcessCallback& cb) //throw X
+void FolderPairSyncer::runPass(PassNo pass, SyncCtx& syncCtx, BaseFolderPair& baseFolder, AsyncCallback& acb, size_t statusPrio) //throw ThreadInterruption
 {
     const size_t threadCount = std::max<size_t>(syncCtx.threadCount, 1);
 
-    std::mutex singleThread; //only a single worker thread may run at a time, except for parallel file I/O
-
-    AsyncCallback acb;                                //
-    FolderPairSyncer fps(syncCtx, singleThread, acb); //manage life time: enclose InterruptibleThread's!!!
-    Workload workload(threadCount, acb);              //
-    workload.addWorkItems(fps.getFolderLevelWorkItems(pass, baseFolder, workload)); //initial workload: set *before* threads get access!
+    FolderPairSyncer fps(syncCtx, acb);  //manage life time: enclose InterruptibleThread's!!!
+    SyncWorkload workload(threadCount); //
+    assert(pass == PASS_ZERO || pass == PASS_ONE);
+    workload.addWorkItems(pass == PASS_ZERO ? //initial workload: set *before* threads get access!
+                          fps.getPassZeroWorkItems(baseFolder) :
+                          fps.getPassOneTwoWorkItems(baseFolder));
 
     std::vector<InterruptibleThread> worker;
     ZEN_ON_SCOPE_EXIT( for (InterruptibleThread& wt : worker) wt.join     (); ); //
     ZEN_ON_SCOPE_EXIT( for (InterruptibleThread& wt : worker) wt.interrupt(); ); //interrupt all first, then join
 
     for (size_t threadIdx = 0; threadIdx < threadCount; ++threadIdx)
-        worker.emplace_back([threadIdx, &singleThread, &acb, &workload]
+        worker.emplace_back([threadIdx, statusPrio, &acb, &fps, &workload]
     {
-        setCurrentThreadName(("Sync Worker[" + numberTo<std::string>(threadIdx) + "]").c_str());
+        setCurrentThreadName(("Sync Worker[" + numberTo<std::string>(statusPrio) + "][" + numberTo<std::string>(threadIdx) + "]").c_str());
 
-        while (/*blocking call:*/ std::function<void()> workItem = workload.getNext(threadIdx)) //throw ThreadInterruption
+        std::vector<WorkItem> batch;
+        batch.reserve(SyncWorkload::BATCH_ITEMS_MAX);
+        for (;;)
         {
-            acb.notifyTaskBegin(0 /*prio*/); //same prio, while processing only one folder pair at a time
+            workload.getNext(threadIdx, batch); //throw ThreadInterruption; blocking call
+
+            acb.notifyTaskBegin(statusPrio); //prio by folder pair position: visualize (somewhat) natural processing order
             ZEN_ON_SCOPE_EXIT(acb.notifyTaskEnd());
 
-            std::lock_guard dummy(singleThread); //protect ALL accesses to "fps" and workItem execution!
-            workItem(); //throw ThreadInterruption
+            for (const WorkItem& wi : batch)
+                fps.runWorkItem(wi, workload); //throw ThreadInterruption
         }
     });
 
-    acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, cb); //throw X
+    workload.waitUntilDone(); //throw ThreadInterruption
+}
+
+
+void FolderPairSyncer::runWorkItem(const WorkItem& wi, SyncWorkload& workload) //throw ThreadInterruption
+{
+    switch (wi.type)
+    {
+        case WorkType::PREPARE_FILE_MOVE:
+            prepareFileMove(static_cast<FilePair&>(*wi.fsObj)); //throw ThreadInterruption
+            break;
+
+        case WorkType::PASS_ONE_FOLDER:
+        {
+            FolderPair& folder = static_cast<FolderPair&>(*wi.fsObj);
+            tryReportingError([&] { synchronizeFolder(folder); }, acb_); //throw ThreadInterruption
+
+            RingBuffer<SyncWorkload::WorkItems> buckets;
+            {
+                std::lock_guard dummy(lockHierarchy_);
+                //sub items are gone, unless deletion failed: process them like any other folder level
+                FolderLevel& subLevel = addFolderLevel(folder, &folder, wi.level, true /*folderOpDone*/);
+                addPassOneItems(subLevel, buckets);
+                if (wi.level->active)
+                    activateFolderLevel(subLevel, buckets);
+            }
+            workload.addWorkItems(std::move(buckets));
+
+            notifyPassOneDone(wi, workload); //*after* sub level was added: keep PASS_TWO parent folder operations waiting
+        }
+        break;
+
+        case WorkType::PASS_ONE_FILE:
+            tryReportingError([&] { synchronizeFile(static_cast<FilePair&>(*wi.fsObj)); }, acb_); //throw ThreadInterruption
+            notifyPassOneDone(wi, workload);
+            break;
+
+        case WorkType::PASS_ONE_LINK:
+            tryReportingError([&] { synchronizeLink(static_cast<SymlinkPair&>(*wi.fsObj)); }, acb_); //throw ThreadInterruption
+            notifyPassOneDone(wi, workload);
+            break;
+
+        case WorkType::PASS_TWO_FOLDER:
+        {
+            tryReportingError([&] { synchronizeFolder(static_cast<FolderPair&>(*wi.fsObj)); }, acb_); //throw ThreadInterruption
+
+            RingBuffer<SyncWorkload::WorkItems> buckets;
+            {
+                std::lock_guard dummy(lockHierarchy_);
+                wi.level->folderOpDone = true;
+                activateFolderLevel(*wi.level, buckets);
+            }
+            workload.addWorkItems(std::move(buckets));
+        }
+        break;
+
+        case WorkType::PASS_TWO_FILE:
+            tryReportingError([&] { synchronizeFile(static_cast<FilePair&>(*wi.fsObj)); }, acb_); //throw ThreadInterruption
+            break;
+
+        case WorkType::PASS_TWO_LINK:
+            tryReportingError([&] { synchronizeLink(static_cast<SymlinkPair&>(*wi.fsObj)); }, acb_); //throw ThreadInterruption
+            break;
+    }
 }
 
 
-//thread-safe thanks to std::mutex singleThread
-RingBuffer<Workload::WorkItems> FolderPairSyncer::getFolderLevelWorkItems(PassNo pass, ContainerObject& parentFolder, Workload& workload)
+RingBuffer<FolderPairSyncer::SyncWorkload::WorkItems> FolderPairSyncer::getPassZeroWorkItems(ContainerObject& baseFolder)
 {
-    RingBuffer<Workload::WorkItems> buckets;
+    std::lock_guard dummy(lockHierarchy_); //needZeroPass() evaluates sync operations (and move references)
+
+    RingBuffer<SyncWorkload::WorkItems> buckets;
 
     RingBuffer<ContainerObject*> foldersToInspect;
-    foldersToInspect.push_back(&parentFolder);
+    foldersToInspect.push_back(&baseFolder);
 
     while (!foldersToInspect.empty())
     {
         ContainerObject& hierObj = *foldersToInspect.    front();
         /**/                        foldersToInspect.pop_front();
 
-        RingBuffer<std::function<void()>> workItems;
-
-        //synchronize folders:
         for (FolderPair& folder : hierObj.refSubFolders())
-            if (pass == getPass(folder))
-                workItems.push_back([this, &folder, &workload, pass]
-            {
-                tryReportingError([&] { synchronizeFolder(folder); }, acb_); //throw ThreadInterruption
-
-                workload.addWorkItems(getFolderLevelWorkItems(pass, folder, workload));
-            });
-        else
             foldersToInspect.push_back(&folder);
 
-        //synchronize files:
+        SyncWorkload::WorkItems workItems;
+
         for (FilePair& file : hierObj.refSubFiles())
-            if (pass == PASS_ZERO)
+            if (needZeroPass(file))
+                workItems.push_back(WorkItem{ WorkType::PREPARE_FILE_MOVE, false /*batchable*/, &file, nullptr, 0 });
+
+        if (!workItems.empty())
+            buckets.push_back(std::move(workItems));
+    }
+    return buckets;
+}
+
+
+RingBuffer<FolderPairSyncer::SyncWorkload::WorkItems> FolderPairSyncer::getPassOneTwoWorkItems(ContainerObject& baseFolder)
+{
+    std::lock_guard dummy(lockHierarchy_);
+
+    RingBuffer<SyncWorkload::WorkItems> buckets;
+
+    FolderLevel& baseLevel = addFolderLevel(baseFolder, nullptr, nullptr, true /*folderOpDone*/);
+    addPassOneItems(baseLevel, buckets);  //PASS_ONE items first: free disk space early
+    activateFolderLevel(baseLevel, buckets); //PASS_TWO items without pending dependencies
+    return buckets;
+}
+
+
+auto FolderPairSyncer::addFolderLevel(ContainerObject& hierObj, FolderPair* folder, FolderLevel* parentLevel, bool folderOpDone) -> FolderLevel&
+{
+    folderLevels_.push_back({ hierObj, folder ? folder->getId() : nullptr, parentLevel, folderOpDone });
+    FolderLevel& level = folderLevels_.back(); //std::deque: references stay valid
+
+    if (parentLevel)
+        parentLevel->subLevels.push_back(&level);
+    return level;
+}
+
+
+void FolderPairSyncer::addPassOneItems(FolderLevel& startLevel, RingBuffer<SyncWorkload::WorkItems>& buckets)
+{
+    std::vector<FolderLevel*> newLevels{ &startLevel }; //breadth-first order
+
+    for (size_t i = 0; i < newLevels.size(); ++i)
+    {
+        FolderLevel& level = *newLevels[i];
+        SyncWorkload::WorkItems workItems;
+
+        //delete folders:
+        for (FolderPair& folder : level.hierObj.refSubFolders())
+            if (getPass(folder) == PASS_ONE)
             {
-                if (needZeroPass(file))
-                    workItems.push_back([this, &file] { prepareFileMove(file); /*throw ThreadInterruption*/ });
+                ++level.pendingDirect;
+                SpaceRelease* spaceRelease = getSpaceRelease(folder);
+                if (spaceRelease)
+                    ++spaceRelease->pending;
+                workItems.push_back(WorkItem{ WorkType::PASS_ONE_FOLDER, false /*batchable*/, &folder, &level, 0, spaceRelease });
             }
-            else if (pass == getPass(file))
-                workItems.push_back([this, &file]
+            else
+                newLevels.push_back(&addFolderLevel(folder, &folder, &level, getPass(folder) != PASS_TWO /*folderOpDone*/));
+
+        //delete files (or overwrite big ones with smaller ones):
+        for (FilePair& file : level.hierObj.refSubFiles())
+            if (getPass(file) == PASS_ONE)
             {
-                tryReportingError([&] { synchronizeFile(file); }, acb_); //throw ThreadInterruption
-            });
+                ++level.pendingDirect;
+                SpaceRelease* spaceRelease = getSpaceRelease(file);
+                if (spaceRelease)
+                    ++spaceRelease->pending;
+                workItems.push_back(WorkItem{ WorkType::PASS_ONE_FILE, true /*batchable*/, &file, &level, static_cast<uint64_t>(SyncStatistics(file).getBytesToProcess()), spaceRelease });
+            }
 
-        //synchronize symbolic links:
-        for (SymlinkPair& symlink : hierObj.refSubLinks())
-            if (pass == getPass(symlink))
-                workItems.push_back([this, &symlink]
+        //delete symbolic links:
+        for (SymlinkPair& symlink : level.hierObj.refSubLinks())
+            if (getPass(symlink) == PASS_ONE)
             {
-                tryReportingError([&] { synchronizeLink(symlink); }, acb_); //throw ThreadInterruption
-            });
+                ++level.pendingDirect;
+                workItems.push_back(WorkItem{ WorkType::PASS_ONE_LINK, true /*batchable*/, &symlink, &level, 0 });
+            }
 
         if (!workItems.empty())
             buckets.push_back(std::move(workItems));
     }
 
-    return buckets;
+    //count pending sub levels: reverse breadth-first order => sub levels before their parents
+    for (auto it = newLevels.rbegin(); it != newLevels.rend(); ++it)
+    {
+        FolderLevel& level = **it;
+        level.pendingSubtree += level.pendingDirect;
+
+        if (level.pendingSubtree > 0 && level.parent)
+            ++level.parent->pendingSubtree;
+    }
+}
+
+
+void FolderPairSyncer::notifyPassOneDone(const WorkItem& wi, SyncWorkload& workload)
+{
+    FolderLevel& level = *wi.level;
+
+    RingBuffer<SyncWorkload::WorkItems> buckets;
+    {
+        std::lock_guard dummy(lockHierarchy_);
+
+        if (wi.spaceRelease)
+        {
+            assert(wi.spaceRelease->pending > 0);
+            if (--wi.spaceRelease->pending == 0 && !wi.spaceRelease->waiting.empty())
+            {
+                buckets.push_back(std::move(wi.spaceRelease->waiting));
+                wi.spaceRelease->waiting.clear(); //"moved-from" state is unspecified
+            }
+        }
+
+        assert(level.pendingDirect > 0);
+        --level.pendingDirect;
+
+        for (FolderLevel* lvl = &level; lvl; lvl = lvl->parent)
+        {
+            assert(lvl->pendingSubtree > 0);
+            if (--lvl->pendingSubtree > 0)
+                break;
+
+            //no more PASS_ONE items inside folder => ready for PASS_TWO folder operation (if parent level is)
+            if (!lvl->folderOpDone && lvl->parent && lvl->parent->passTwoReleased)
+                if (FileSystemObject* folder = FileSystemObject::retrieve(lvl->folderId))
+                {
+                    SyncWorkload::WorkItems workItems;
+                    workItems.push_back(WorkItem{ WorkType::PASS_TWO_FOLDER, false /*batchable*/, folder, lvl, 0 });
+                    buckets.push_back(std::move(workItems));
+                }
+        }
+
+        if (level.pendingDirect == 0 && level.active)
+            addPassTwoItems(level, buckets);
+    }
+    workload.addWorkItems(std::move(buckets));
+}
+
+
+void FolderPairSyncer::activateFolderLevel(FolderLevel& startLevel, RingBuffer<SyncWorkload::WorkItems>& buckets)
+{
+    RingBuffer<FolderLevel*> levels;
+    levels.push_back(&startLevel);
+
+    while (!levels.empty())
+    {
+        FolderLevel& level = *levels.    front();
+        /**/                  levels.pop_front();
+
+        assert(level.folderOpDone && !level.active);
+        level.active = true;
+
+        if (level.pendingDirect == 0)
+            addPassTwoItems(level, buckets);
+
+        for (FolderLevel* subLevel : level.subLevels)
+            if (subLevel->folderOpDone)
+                levels.push_back(subLevel);
+    }
+}
+
+
+void FolderPairSyncer::addPassTwoItems(FolderLevel& level, RingBuffer<SyncWorkload::WorkItems>& buckets)
+{
+    assert(level.active && level.pendingDirect == 0 && !level.passTwoReleased);
+    level.passTwoReleased = true;
+
+    if (level.folderId && !FileSystemObject::retrieve(level.folderId))
+        return; //folder was removed from model meanwhile: e.g. parent folder creation found source missing
+
+    SyncWorkload::WorkItems workItems;
+
+    //PASS_TWO folder operations: wait for PASS_ONE items inside folder
+    for (FolderLevel* subLevel : level.subLevels)
+        if (!subLevel->folderOpDone && subLevel->pendingSubtree == 0)
+            if (FileSystemObject* folder = FileSystemObject::retrieve(subLevel->folderId))
+                workItems.push_back(WorkItem{ WorkType::PASS_TWO_FOLDER, false /*batchable*/, folder, subLevel, 0 });
+
+    //create, modify files:
+    for (FilePair& file : level.hierObj.refSubFiles())
+        if (getPass(file) == PASS_TWO)
+        {
+            const WorkItem wi{ WorkType::PASS_TWO_FILE, true /*batchable*/, &file, nullptr, static_cast<uint64_t>(SyncStatistics(file).getBytesToProcess()) };
+
+            //don't rely on queue order: copy only after space was freed on the target device, even if in a different folder level
+            SpaceRelease* spaceRelease = getSpaceRelease(file);
+            if (spaceRelease && spaceRelease->pending > 0)
+                spaceRelease->waiting.push_back(wi);
+            else
+                workItems.push_back(wi);
+        }
+
+    //create, modify symbolic links:
+    for (SymlinkPair& symlink : level.hierObj.refSubLinks())
+        if (getPass(symlink) == PASS_TWO)
+            workItems.push_back(WorkItem{ WorkType::PASS_TWO_LINK, true /*batchable*/, &symlink, nullptr, 0 });
+
+    if (!workItems.empty())
+        buckets.push_back(std::move(workItems));
+}
+
+
+auto FolderPairSyncer::getSpaceRelease(const FileSystemObject& fsObj) -> SpaceRelease*
+{
+    switch (fsObj.getSyncOperation())
+    {
+        case SO_DELETE_LEFT:
+        case SO_OVERWRITE_LEFT:
+        case SO_CREATE_NEW_LEFT:
+            return &spaceRelease_[fsObj.base().getAbstractPath<LEFT_SIDE>().afsDevice];
+
+        case SO_DELETE_RIGHT:
+        case SO_OVERWRITE_RIGHT:
+        case SO_CREATE_NEW_RIGHT:
+            return &spaceRelease_[fsObj.base().getAbstractPath<RIGHT_SIDE>().afsDevice];
+
+        case SO_MOVE_LEFT_FROM:
+        case SO_MOVE_RIGHT_FROM:
+        case SO_MOVE_LEFT_TO:
+        case SO_MOVE_RIGHT_TO:
+        case SO_COPY_METADATA_TO_LEFT:
+        case SO_COPY_METADATA_TO_RIGHT:
+        case SO_DO_NOTHING:
+        case SO_EQUAL:
+        case SO_UNRESOLVED_CONFLICT:
+            break;
+    }
+    return nullptr;
 }
 
 
@@ -1175,7 +1599,8 @@ bool haveNameClash(const Zstring& itemName, const List& m)
 
 template <SelectedSide side>
 void FolderPairSyncer::setup2StepMove(FilePair& sourceFile, //throw FileError, ThreadInterruption
-                                      FilePair& targetFile)
+                                      FilePair& targetFile,
+                                      std::unique_lock<std::mutex>& hierarchyLock)
 {
     //generate (hopefully) unique file name to avoid clashing with some remnant ffs_tmp file
     const Zstring shortGuid = printNumber<Zstring>(Zstr("%04x"), static_cast<unsigned int>(getCrc16(generateGUID())));
@@ -1194,13 +1619,14 @@ void FolderPairSyncer::setup2StepMove(FilePair& sourceFile, //throw FileError, T
                AFS::getDisplayPath(sourceFile.getAbstractPath<side>()),
                AFS::getDisplayPath(sourcePathTmp));
 
-    parallel::moveAndRenameItem(sourceFile.getAbstractPath<side>(), sourcePathTmp, singleThread_); //throw FileError, (ErrorDifferentVolume)
+    const AbstractPath sourcePath = sourceFile.getAbstractPath<side>();
+    parallelScope([&] { AFS::moveAndRenameItem(sourcePath, sourcePathTmp); /*throw FileError, (ErrorDifferentVolume)*/ }, hierarchyLock);
 
     //TODO: prepare2StepMove: consider ErrorDifferentVolume! e.g. symlink aliasing!
 
     //update file hierarchy
     FilePair& tempFile = sourceFile.base().addSubFile<side>(afterLast(sourceRelPathTmp, FILE_NAME_SEPARATOR, IF_MISSING_RETURN_ALL), sourceFile.getAttributes<side>());
-    static_assert(std::is_same_v<ContainerObject::FileList, std::list<FilePair>>,
+    static_assert(std::is_same_v<ContainerObject::FileList, std::list<FilePair, ContainerObject::FileList::allocator_type>>,
                   "ATTENTION: we're adding to the file list WHILE looping over it! This is only working because std::list iterators are not invalidated by insertion!");
     sourceFile.removeObject<side>(); //remove only *after* evaluating "sourceFile, side"!
     //note: this new item is *not* considered at the end of 0th pass because "!sourceWillBeDeleted && !haveNameClash"
@@ -1219,11 +1645,11 @@ void FolderPairSyncer::setup2StepMove(FilePair& sourceFile, //throw FileError, T
 //         CmtfStatus::NAME_CLASH
 //         CmtfStatus::SOURCE_MISSING
 template <SelectedSide side>
-auto FolderPairSyncer::createMoveTargetFolder(FileSystemObject& fsObj) -> CmtfStatus //throw FileError, ThreadInterruption
+auto FolderPairSyncer::createMoveTargetFolder(FileSystemObject& fsObj, std::unique_lock<std::mutex>& hierarchyLock) -> CmtfStatus //throw FileError, ThreadInterruption
 {
     if (auto parentFolder = dynamic_cast<FolderPair*>(&fsObj.parent()))
     {
-        const CmtfStatus cmtfs = createMoveTargetFolder<side>(*parentFolder);
+        const CmtfStatus cmtfs = createMoveTargetFolder<side>(*parentFolder, hierarchyLock);
         if (cmtfs != CmtfStatus::AVAILABLE)
             return cmtfs;
 
@@ -1242,22 +1668,23 @@ auto FolderPairSyncer::createMoveTargetFolder(FileSystemObject& fsObj) -> CmtfSt
             case SO_CREATE_NEW_LEFT:
             case SO_CREATE_NEW_RIGHT:
             {
+                const AbstractPath sourcePath = parentFolder->getAbstractPath<sideSrc>();
                 const AbstractPath targetPath = parentFolder->getAbstractPath<side>();
                 reportInfo(txtCreatingFolder_, AFS::getDisplayPath(targetPath)); //throw ThreadInterruption
 
                 //shallow-"copying" a folder might not fail if source is missing, so we need to check this first:
-                if (parallel::itemStillExists(parentFolder->getAbstractPath<sideSrc>(), singleThread_)) //throw FileError
+                if (parallelScope([&] { return AFS::itemStillExists(sourcePath); /*throw FileError*/ }, hierarchyLock))
                 {
                     AsyncItemStatReporter statReporter(1, 0, acb_);
                     try 
                     {
 						//target existing: fail/ignore
-                        parallel::copyNewFolder(parentFolder->getAbstractPath<sideSrc>(), targetPath, copyFilePermissions_, singleThread_); //throw FileError
+                        parallelScope([&] { AFS::copyNewFolder(sourcePath, targetPath, copyFilePermissions_); /*throw FileError*/ }, hierarchyLock);
                     }
                     catch (FileError&)
                     {
                         bool folderAlreadyExists = false;
-                        try { folderAlreadyExists = parallel::getItemType(targetPath, singleThread_) == AFS::ItemType::FOLDER; } /*throw FileError*/ catch (FileError&) {}
+                        try { folderAlreadyExists = parallelScope([&] { return AFS::getItemType(targetPath); /*throw FileError*/ }, hierarchyLock) == AFS::ItemType::FOLDER; } catch (FileError&) {}
                         if (!folderAlreadyExists) //previous exception is more relevant; good enough? https://freefilesync.org/forum/viewtopic.php?t=5266
                             throw;
                     }
@@ -1309,7 +1736,8 @@ auto FolderPairSyncer::createMoveTargetFolder(FileSystemObject& fsObj) -> CmtfSt
 
 template <SelectedSide side>
 void FolderPairSyncer::resolveMoveConflicts(FilePair& sourceFile, //throw FileError, ThreadInterruption
-                                            FilePair& targetFile)
+                                            FilePair& targetFile,
+                                            std::unique_lock<std::mutex>& hierarchyLock)
 {
     assert((sourceFile.getSyncOperation() == SO_MOVE_LEFT_FROM  && targetFile.getSyncOperation() == SO_MOVE_LEFT_TO  && side == LEFT_SIDE) ||
            (sourceFile.getSyncOperation() == SO_MOVE_RIGHT_FROM && targetFile.getSyncOperation() == SO_MOVE_RIGHT_TO && side == RIGHT_SIDE));
@@ -1350,11 +1778,11 @@ void FolderPairSyncer::resolveMoveConflicts(FilePair& sourceFile, //throw FileEr
     {
         //prepare for move now: - revert to 2-step move on name clashes
         if (haveNameClash(targetFile) ||
-            createMoveTargetFolder<side>(targetFile) == CmtfStatus::NAME_CLASH) //throw FileError, ThreadInterruption
-            return setup2StepMove<side>(sourceFile, targetFile); //throw FileError, ThreadInterruption
+            createMoveTargetFolder<side>(targetFile, hierarchyLock) == CmtfStatus::NAME_CLASH) //throw FileError, ThreadInterruption
+            return setup2StepMove<side>(sourceFile, targetFile, hierarchyLock); //throw FileError, ThreadInterruption
 
         //finally start move! this should work now:
-        synchronizeFile(targetFile); //throw FileError, ThreadInterruption
+        parallelScope([&] { synchronizeFile(targetFile); /*throw FileError, ThreadInterruption*/ }, hierarchyLock); //locks as needed
         //- FolderPairSyncer::synchronizeFileInt() is *not* expecting SO_MOVE_LEFT_FROM/SO_MOVE_RIGHT_FROM => start move from targetFile, not sourceFile!
         //- function call will be NOOP if CmtfStatus::SOURCE_MISSING
     }
@@ -1365,6 +1793,8 @@ void FolderPairSyncer::resolveMoveConflicts(FilePair& sourceFile, //throw FileEr
 
 void FolderPairSyncer::prepareFileMove(FilePair& file) //throw ThreadInterruption
 {
+    std::unique_lock hierarchyLock(lockHierarchy_);
+
     const SyncOperation syncOp = file.getSyncOperation();
     switch (syncOp) //evaluate comparison result and sync direction
     {
@@ -1375,13 +1805,19 @@ void FolderPairSyncer::prepareFileMove(FilePair& file) //throw ThreadInterruptio
                 FilePair* sourceObj = &file;
                 assert(targetObj->getMoveRef() == sourceObj->getId());
 
-                const std::wstring errMsg = tryReportingError([&] //throw ThreadInterruption
+                const std::wstring errMsg = parallelScope([&] //don't block other threads while waiting for user response
                 {
-                    if (syncOp == SO_MOVE_LEFT_FROM)
-                        resolveMoveConflicts<LEFT_SIDE>(*sourceObj, *targetObj); //throw FileError, ThreadInterruption
-                    else
-                        resolveMoveConflicts<RIGHT_SIDE>(*sourceObj, *targetObj); //
-                }, acb_); //throw ThreadInterruption
+                    return tryReportingError([&] //throw ThreadInterruption
+                    {
+                        hierarchyLock.lock();
+                        ZEN_ON_SCOPE_EXIT(hierarchyLock.unlock());
+
+                        if (syncOp == SO_MOVE_LEFT_FROM)
+                            resolveMoveConflicts<LEFT_SIDE>(*sourceObj, *targetObj, hierarchyLock); //throw FileError, ThreadInterruption
+                        else
+                            resolveMoveConflicts<RIGHT_SIDE>(*sourceObj, *targetObj, hierarchyLock); //
+                    }, acb_); //throw ThreadInterruption
+                }, hierarchyLock);
 
                 if (!errMsg.empty())
                 {
@@ -1558,17 +1994,73 @@ FolderPairSyncer::PassNo FolderPairSyncer::getPass(const FolderPair& folder)
 
 //---------------------------------------------------------------------------------------------------------------
 
+inline
+std::optional<AfsDevice> getDeviceRead(const FileSystemObject& fsObj, SelectedSide sideSrc, SyncOperation syncOp)
+{
+    switch (syncOp)
+    {
+        case SO_CREATE_NEW_LEFT:
+        case SO_CREATE_NEW_RIGHT:
+        case SO_OVERWRITE_LEFT:
+        case SO_OVERWRITE_RIGHT:
+            return sideSrc == LEFT_SIDE ? fsObj.base().getAbstractPath< LEFT_SIDE>().afsDevice :
+                   /**/                   fsObj.base().getAbstractPath<RIGHT_SIDE>().afsDevice;
+
+        case SO_DELETE_LEFT: //versioning: ignore write access to versioning folder device
+        case SO_DELETE_RIGHT:
+        case SO_MOVE_LEFT_FROM:
+        case SO_MOVE_RIGHT_FROM:
+        case SO_MOVE_LEFT_TO:
+        case SO_MOVE_RIGHT_TO:
+        case SO_COPY_METADATA_TO_LEFT:
+        case SO_COPY_METADATA_TO_RIGHT:
+        case SO_DO_NOTHING:
+        case SO_EQUAL:
+        case SO_UNRESOLVED_CONFLICT:
+            break;
+    }
+    return {};
+}
+
+
+template <SelectedSide sideTrg> inline
+void FolderPairSyncer::acquireDeviceIo(const FileSystemObject& fsObj, SyncOperation syncOp) //throw ThreadInterruption
+{
+    ioLimiter_.acquire(getDeviceRead(fsObj, OtherSide<sideTrg>::value, syncOp), fsObj.base().getAbstractPath<sideTrg>().afsDevice, acb_); //throw ThreadInterruption
+}
+
+
+template <SelectedSide sideTrg> inline
+void FolderPairSyncer::releaseDeviceIo(const FileSystemObject& fsObj, SyncOperation syncOp) //noexcept
+{
+    ioLimiter_.release(getDeviceRead(fsObj, OtherSide<sideTrg>::value, syncOp), fsObj.base().getAbstractPath<sideTrg>().afsDevice);
+}
+
+//---------------------------------------------------------------------------------------------------------------
+
 inline
 void FolderPairSyncer::synchronizeFile(FilePair& file) //throw FileError, ThreadInterruption
 {
-    const SyncOperation syncOp = file.getSyncOperation();
+    const SyncOperation syncOp = [&]
+    {
+        std::lock_guard dummy(lockHierarchy_); //may evaluate move reference or child items
+        return file.getSyncOperation();
+    }();
 
     if (std::optional<SelectedSide> sideTrg = getTargetDirection(syncOp))
     {
         if (*sideTrg == LEFT_SIDE)
+        {
+            acquireDeviceIo<LEFT_SIDE>(file, syncOp); //throw ThreadInterruption
+            ZEN_ON_SCOPE_EXIT(releaseDeviceIo<LEFT_SIDE>(file, syncOp));
             synchronizeFileInt<LEFT_SIDE>(file, syncOp);
+        }
         else
+        {
+            acquireDeviceIo<RIGHT_SIDE>(file, syncOp); //throw ThreadInterruption
+            ZEN_ON_SCOPE_EXIT(releaseDeviceIo<RIGHT_SIDE>(file, syncOp));
             synchronizeFileInt<RIGHT_SIDE>(file, syncOp);
+        }
     }
 }
 
@@ -1598,11 +2090,12 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                                                                         targetPath,
                                                                         nullptr, //onDeleteTargetFile: nothing to delete; if existing: undefined behavior! (fail/overwrite/auto-rename)
                                                                         statReporter); //throw FileError, ThreadInterruption
-                if (result.errorModTime)
-                    errorsModTime_.push_back(*result.errorModTime); //show all warnings later as a single message
-
                 statReporter.reportDelta(1, 0);
 
+                if (result.errorModTime)
+                    errorsModTime_.access([&](std::vector<FileError>& errors) { errors.push_back(*result.errorModTime); }); //show all warnings later as a single message
+
+                std::lock_guard dummy(lockHierarchy_);
                 //update FilePair
                 file.setSyncedTo<sideTrg>(file.getItemName<sideSrc>(), result.fileSize,
                                           result.modTime, //target time set from source
@@ -1614,14 +2107,17 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
             catch (const FileError& e)
             {
                 bool sourceWasDeleted = false;
-                try { sourceWasDeleted = !parallel::itemStillExists(file.getAbstractPath<sideSrc>(), singleThread_); /*throw FileError*/ }
+                try { sourceWasDeleted = !AFS::itemStillExists(file.getAbstractPath<sideSrc>()); /*throw FileError*/ }
                 catch (const FileError& e2) { throw FileError(e.toString(), e2.toString()); } //unclear which exception is more relevant
                 //do not check on type (symlink, file, folder) -> if there is a type change, FFS should not be quiet about it!
 
                 if (sourceWasDeleted)
                 {
                     statReporter.reportDelta(1, 0); //even if the source item does not exist anymore, significant I/O work was done => report
-                    file.removeObject<sideSrc>(); //source deleted meanwhile...nothing was done (logical point of view!)
+                    {
+                        std::lock_guard dummy(lockHierarchy_);
+                        file.removeObject<sideSrc>(); //source deleted meanwhile...nothing was done (logical point of view!)
+                    }
 
                     reportInfo(txtSourceItemNotFound_, AFS::getDisplayPath(file.getAbstractPath<sideSrc>())); //throw ThreadInterruption
                 }
@@ -1638,13 +2134,18 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                 AsyncItemStatReporter statReporter(1, 0, acb_);
 
                 delHandlerTrg.removeFileWithCallback({ file.getAbstractPath<sideTrg>(), file.getAttributes<sideTrg>() },
-                                                     file.getRelativePath<sideTrg>(), statReporter, singleThread_); //throw FileError, X
+                                                     file.getRelativePath<sideTrg>(), statReporter); //throw FileError, X
+
+                std::lock_guard dummy(lockHierarchy_);
                 file.removeObject<sideTrg>(); //update FilePair
             }
             break;
 
         case SO_MOVE_LEFT_TO:
         case SO_MOVE_RIGHT_TO:
+        {
+            std::unique_lock hierarchyLock(lockHierarchy_); //"moveFrom" is not owned by this work item
+
             if (FilePair* moveFrom = dynamic_cast<FilePair*>(FileSystemObject::retrieve(file.getMoveRef())))
             {
                 FilePair* moveTo = &file;
@@ -1656,15 +2157,18 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                 const AbstractPath pathFrom = moveFrom->getAbstractPath<sideTrg>();
                 const AbstractPath pathTo   = moveTo  ->getAbstractPath<sideTrg>();
 
-                reportInfo(txtMovingFileXtoY_, AFS::getDisplayPath(pathFrom), AFS::getDisplayPath(pathTo)); //throw ThreadInterruption
+                parallelScope([&]
+                {
+                    reportInfo(txtMovingFileXtoY_, AFS::getDisplayPath(pathFrom), AFS::getDisplayPath(pathTo)); //throw ThreadInterruption
 
-                AsyncItemStatReporter statReporter(1, 0, acb_);
+                    AsyncItemStatReporter statReporter(1, 0, acb_);
 
-                //TODO: synchronizeFileInt: consider ErrorDifferentVolume! e.g. symlink aliasing!
+                    //TODO: synchronizeFileInt: consider ErrorDifferentVolume! e.g. symlink aliasing!
 
-                parallel::moveAndRenameItem(pathFrom, pathTo, singleThread_); //throw FileError, (ErrorDifferentVolume)
+                    AFS::moveAndRenameItem(pathFrom, pathTo); //throw FileError, (ErrorDifferentVolume)
 
-                statReporter.reportDelta(1, 0);
+                    statReporter.reportDelta(1, 0);
+                }, hierarchyLock);
 
                 //update FilePair
                 assert(moveFrom->getFileSize<sideTrg>() == moveTo->getFileSize<sideSrc>());
@@ -1678,7 +2182,8 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                 moveFrom->removeObject<sideTrg>(); //remove only *after* evaluating "moveFrom, sideTrg"!
             }
             else (assert(false));
-            break;
+        }
+        break;
 
         case SO_OVERWRITE_LEFT:
         case SO_OVERWRITE_RIGHT:
@@ -1689,7 +2194,7 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
             AbstractPath targetPathResolvedOld = file.getAbstractPath<sideTrg>(); //support change in case when syncing to case-sensitive SFTP on Windows!
             AbstractPath targetPathResolvedNew = targetPathLogical;
             if (file.isFollowedSymlink<sideTrg>()) //follow link when updating file rather than delete it and replace with regular file!!!
-                targetPathResolvedOld = targetPathResolvedNew = parallel::getSymlinkResolvedPath(file.getAbstractPath<sideTrg>(), singleThread_); //throw FileError
+                targetPathResolvedOld = targetPathResolvedNew = AFS::getSymlinkResolvedPath(file.getAbstractPath<sideTrg>()); //throw FileError
 
             reportInfo(txtUpdatingFile_, AFS::getDisplayPath(targetPathResolvedOld)); //throw ThreadInterruption
 
@@ -1698,7 +2203,7 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
             if (file.isFollowedSymlink<sideTrg>()) //since we follow the link, we need to sync case sensitivity of the link manually!
                 if (getUnicodeNormalForm(file.getItemName<sideTrg>()) !=
                     getUnicodeNormalForm(file.getItemName<sideSrc>())) //have difference in case?
-                    parallel::moveAndRenameItem(file.getAbstractPath<sideTrg>(), targetPathLogical, singleThread_); //throw FileError, (ErrorDifferentVolume)
+                    AFS::moveAndRenameItem(file.getAbstractPath<sideTrg>(), targetPathLogical); //throw FileError, (ErrorDifferentVolume)
 
             auto onDeleteTargetFile = [&] //delete target at appropriate time
             {
@@ -1707,7 +2212,7 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                 FileAttributes followedTargetAttr = file.getAttributes<sideTrg>();
                 followedTargetAttr.isFollowedSymlink = false;
 
-                delHandlerTrg.removeFileWithCallback({ targetPathResolvedOld, followedTargetAttr }, file.getRelativePath<sideTrg>(), statReporter, singleThread_); //throw FileError, X
+                delHandlerTrg.removeFileWithCallback({ targetPathResolvedOld, followedTargetAttr }, file.getRelativePath<sideTrg>(), statReporter); //throw FileError, X
                 //no (logical) item count update desired - but total byte count may change, e.g. move(copy) old file to versioning dir
                 statReporter.reportDelta(-1, 0); //undo item stats reporting within DeletionHandler::removeFileWithCallback()
 
@@ -1722,11 +2227,12 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                                                                     targetPathResolvedNew,
                                                                     onDeleteTargetFile,
                                                                     statReporter); //throw FileError, ThreadInterruption, X
-            if (result.errorModTime)
-                errorsModTime_.push_back(*result.errorModTime); //show all warnings later as a single message
-
             statReporter.reportDelta(1, 0); //we model "delete + copy" as ONE logical operation
 
+            if (result.errorModTime)
+                errorsModTime_.access([&](std::vector<FileError>& errors) { errors.push_back(*result.errorModTime); }); //show all warnings later as a single message
+
+            std::lock_guard dummy(lockHierarchy_);
             //update FilePair
             file.setSyncedTo<sideTrg>(file.getItemName<sideSrc>(), result.fileSize,
                                       result.modTime, //target time set from source
@@ -1747,8 +2253,8 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
 
                 if (getUnicodeNormalForm(file.getItemName<sideTrg>()) !=
                     getUnicodeNormalForm(file.getItemName<sideSrc>())) //have difference in case?
-                    parallel::moveAndRenameItem(file.getAbstractPath<sideTrg>(), //throw FileError, (ErrorDifferentVolume)
-                                                AFS::appendRelPath(file.parent().getAbstractPath<sideTrg>(), file.getItemName<sideSrc>()), singleThread_);
+                    AFS::moveAndRenameItem(file.getAbstractPath<sideTrg>(), //throw FileError, (ErrorDifferentVolume)
+                                           AFS::appendRelPath(file.parent().getAbstractPath<sideTrg>(), file.getItemName<sideSrc>()));
                 else
                     assert(false);
 
@@ -1757,12 +2263,13 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
                 if (file.getLastWriteTime<sideTrg>() != file.getLastWriteTime<sideSrc>())
                     //- no need to call sameFileTime() or respect 2 second FAT/FAT32 precision in this comparison
                     //- do NOT read *current* source file time, but use buffered value which corresponds to time of comparison!
-                    parallel::setModTime(file.getAbstractPath<sideTrg>(), file.getLastWriteTime<sideSrc>()); //throw FileError
+                    AFS::setModTime(file.getAbstractPath<sideTrg>(), file.getLastWriteTime<sideSrc>()); //throw FileError
 #endif
                 statReporter.reportDelta(1, 0);
 
                 //-> both sides *should* be completely equal now...
                 assert(file.getFileSize<sideTrg>() == file.getFileSize<sideSrc>());
+                std::lock_guard dummy(lockHierarchy_);
                 file.setSyncedTo<sideTrg>(file.getItemName<sideSrc>(), file.getFileSize<sideSrc>(),
                                           file.getLastWriteTime<sideTrg>(),
                                           file.getLastWriteTime<sideSrc>(),
@@ -1787,14 +2294,26 @@ void FolderPairSyncer::synchronizeFileInt(FilePair& file, SyncOperation syncOp)
 inline
 void FolderPairSyncer::synchronizeLink(SymlinkPair& link) //throw FileError, ThreadInterruption
 {
-    const SyncOperation syncOp = link.getSyncOperation();
+    const SyncOperation syncOp = [&]
+    {
+        std::lock_guard dummy(lockHierarchy_); //may evaluate move reference or child items
+        return link.getSyncOperation();
+    }();
 
     if (std::optional<SelectedSide> sideTrg = getTargetDirection(syncOp))
     {
         if (*sideTrg == LEFT_SIDE)
+        {
+            acquireDeviceIo<LEFT_SIDE>(link, syncOp); //throw ThreadInterruption
+            ZEN_ON_SCOPE_EXIT(releaseDeviceIo<LEFT_SIDE>(link, syncOp));
             synchronizeLinkInt<LEFT_SIDE>(link, syncOp);
+        }
         else
+        {
+            acquireDeviceIo<RIGHT_SIDE>(link, syncOp); //throw ThreadInterruption
+            ZEN_ON_SCOPE_EXIT(releaseDeviceIo<RIGHT_SIDE>(link, syncOp));
             synchronizeLinkInt<RIGHT_SIDE>(link, syncOp);
+        }
     }
 }
 
@@ -1820,11 +2339,12 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
             AsyncItemStatReporter statReporter(1, 0, acb_);
             try
             {
-                parallel::copySymlink(symlink.getAbstractPath<sideSrc>(), targetPath, copyFilePermissions_, singleThread_); //throw FileError
+                AFS::copySymlink(symlink.getAbstractPath<sideSrc>(), targetPath, copyFilePermissions_); //throw FileError
 
                 statReporter.reportDelta(1, 0);
 
                 //update SymlinkPair
+                std::lock_guard dummy(lockHierarchy_);
                 symlink.setSyncedTo<sideTrg>(symlink.getItemName<sideSrc>(),
                                              symlink.getLastWriteTime<sideSrc>(), //target time set from source
                                              symlink.getLastWriteTime<sideSrc>());
@@ -1833,7 +2353,7 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
             catch (const FileError& e)
             {
                 bool sourceExists = true;
-                try { sourceExists = !!parallel::itemStillExists(symlink.getAbstractPath<sideSrc>(), singleThread_); /*throw FileError*/ }
+                try { sourceExists = !!AFS::itemStillExists(symlink.getAbstractPath<sideSrc>()); /*throw FileError*/ }
                 catch (const FileError& e2) { throw FileError(e.toString(), e2.toString()); } //unclear which exception is more relevant
                 //do not check on type (symlink, file, folder) -> if there is a type change, FFS should not be quiet about it!
 
@@ -1841,7 +2361,10 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
                 {
                     //even if the source item does not exist anymore, significant I/O work was done => report
                     statReporter.reportDelta(1, 0);
-                    symlink.removeObject<sideSrc>(); //source deleted meanwhile...nothing was done (logical point of view!)
+                    {
+                        std::lock_guard dummy(lockHierarchy_);
+                        symlink.removeObject<sideSrc>(); //source deleted meanwhile...nothing was done (logical point of view!)
+                    }
 
                     reportInfo(txtSourceItemNotFound_, AFS::getDisplayPath(symlink.getAbstractPath<sideSrc>())); //throw ThreadInterruption
                 }
@@ -1857,8 +2380,9 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
             {
                 AsyncItemStatReporter statReporter(1, 0, acb_);
 
-                delHandlerTrg.removeLinkWithCallback(symlink.getAbstractPath<sideTrg>(), symlink.getRelativePath<sideTrg>(), statReporter, singleThread_); //throw FileError, X
+                delHandlerTrg.removeLinkWithCallback(symlink.getAbstractPath<sideTrg>(), symlink.getRelativePath<sideTrg>(), statReporter); //throw FileError, X
 
+                std::lock_guard dummy(lockHierarchy_);
                 symlink.removeObject<sideTrg>(); //update SymlinkPair
             }
             break;
@@ -1870,7 +2394,7 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
                 AsyncItemStatReporter statReporter(1, 0, acb_);
 
                 //reportStatus(delHandlerTrg.getTxtRemovingSymLink(), AFS::getDisplayPath(symlink.getAbstractPath<sideTrg>()));
-                delHandlerTrg.removeLinkWithCallback(symlink.getAbstractPath<sideTrg>(), symlink.getRelativePath<sideTrg>(), statReporter, singleThread_); //throw FileError, X
+                delHandlerTrg.removeLinkWithCallback(symlink.getAbstractPath<sideTrg>(), symlink.getRelativePath<sideTrg>(), statReporter); //throw FileError, X
                 statReporter.reportDelta(-1, 0); //undo item stats reporting within DeletionHandler::removeLinkWithCallback()
 
                 //symlink.removeObject<sideTrg>(); -> "symlink, sideTrg" evaluated below!
@@ -1878,13 +2402,14 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
                 //=> don't risk reportStatus() throwing ThreadInterruption() leaving the target deleted rather than updated:
                 //reportStatus(txtUpdatingLink_, AFS::getDisplayPath(symlink.getAbstractPath<sideTrg>())); //restore status text
 
-                parallel::copySymlink(symlink.getAbstractPath<sideSrc>(),
-                                      AFS::appendRelPath(symlink.parent().getAbstractPath<sideTrg>(), symlink.getItemName<sideSrc>()), //respect differences in case of source object
-                                      copyFilePermissions_, singleThread_); //throw FileError
+                AFS::copySymlink(symlink.getAbstractPath<sideSrc>(),
+                                 AFS::appendRelPath(symlink.parent().getAbstractPath<sideTrg>(), symlink.getItemName<sideSrc>()), //respect differences in case of source object
+                                 copyFilePermissions_); //throw FileError
 
                 statReporter.reportDelta(1, 0); //we model "delete + copy" as ONE logical operation
 
                 //update SymlinkPair
+                std::lock_guard dummy(lockHierarchy_);
                 symlink.setSyncedTo<sideTrg>(symlink.getItemName<sideSrc>(),
                                              symlink.getLastWriteTime<sideSrc>(), //target time set from source
                                              symlink.getLastWriteTime<sideSrc>());
@@ -1899,19 +2424,20 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
 
                 if (getUnicodeNormalForm(symlink.getItemName<sideTrg>()) !=
                     getUnicodeNormalForm(symlink.getItemName<sideSrc>())) //have difference in case?
-                    parallel::moveAndRenameItem(symlink.getAbstractPath<sideTrg>(), //throw FileError, (ErrorDifferentVolume)
-                                                AFS::appendRelPath(symlink.parent().getAbstractPath<sideTrg>(), symlink.getItemName<sideSrc>()), singleThread_);
+                    AFS::moveAndRenameItem(symlink.getAbstractPath<sideTrg>(), //throw FileError, (ErrorDifferentVolume)
+                                           AFS::appendRelPath(symlink.parent().getAbstractPath<sideTrg>(), symlink.getItemName<sideSrc>()));
                 else
                     assert(false);
 
                 //if (symlink.getLastWriteTime<sideTrg>() != symlink.getLastWriteTime<sideSrc>())
                 //    //- no need to call sameFileTime() or respect 2 second FAT/FAT32 precision in this comparison
                 //    //- do NOT read *current* source file time, but use buffered value which corresponds to time of comparison!
-                //    parallel::setModTimeSymlink(symlink.getAbstractPath<sideTrg>(), symlink.getLastWriteTime<sideSrc>()); //throw FileError
+                //    AFS::setModTimeSymlink(symlink.getAbstractPath<sideTrg>(), symlink.getLastWriteTime<sideSrc>()); //throw FileError
 
                 statReporter.reportDelta(1, 0);
 
                 //-> both sides *should* be completely equal now...
+                std::lock_guard dummy(lockHierarchy_);
                 symlink.setSyncedTo<sideTrg>(symlink.getItemName<sideSrc>(),
                                              symlink.getLastWriteTime<sideTrg>(), //target time set from source
                                              symlink.getLastWriteTime<sideSrc>());
@@ -1934,14 +2460,26 @@ void FolderPairSyncer::synchronizeLinkInt(SymlinkPair& symlink, SyncOperation sy
 inline
 void FolderPairSyncer::synchronizeFolder(FolderPair& folder) //throw FileError, ThreadInterruption
 {
-    const SyncOperation syncOp = folder.getSyncOperation();
+    const SyncOperation syncOp = [&]
+    {
+        std::lock_guard dummy(lockHierarchy_); //may evaluate move reference or child items
+        return folder.getSyncOperation();
+    }();
 
     if (std::optional<SelectedSide> sideTrg = getTargetDirection(syncOp))
     {
         if (*sideTrg == LEFT_SIDE)
+        {
+            acquireDeviceIo<LEFT_SIDE>(folder, syncOp); //throw ThreadInterruption
+            ZEN_ON_SCOPE_EXIT(releaseDeviceIo<LEFT_SIDE>(folder, syncOp));
             synchronizeFolderInt<LEFT_SIDE>(folder, syncOp);
+        }
         else
+        {
+            acquireDeviceIo<RIGHT_SIDE>(folder, syncOp); //throw ThreadInterruption
+            ZEN_ON_SCOPE_EXIT(releaseDeviceIo<RIGHT_SIDE>(folder, syncOp));
             synchronizeFolderInt<RIGHT_SIDE>(folder, syncOp);
+        }
     }
 }
 
@@ -1965,18 +2503,18 @@ void FolderPairSyncer::synchronizeFolderInt(FolderPair& folder, SyncOperation sy
             reportInfo(txtCreatingFolder_, AFS::getDisplayPath(targetPath)); //throw ThreadInterruption
 
             //shallow-"copying" a folder might not fail if source is missing, so we need to check this first:
-            if (parallel::itemStillExists(folder.getAbstractPath<sideSrc>(), singleThread_)) //throw FileError
+            if (AFS::itemStillExists(folder.getAbstractPath<sideSrc>())) //throw FileError
             {
                 AsyncItemStatReporter statReporter(1, 0, acb_);
                 try
                 {
                     //target existing: fail/ignore
-                    parallel::copyNewFolder(folder.getAbstractPath<sideSrc>(), targetPath, copyFilePermissions_, singleThread_); //throw FileError
+                    AFS::copyNewFolder(folder.getAbstractPath<sideSrc>(), targetPath, copyFilePermissions_); //throw FileError
                 }
                 catch (FileError&)
                 {
                     bool folderAlreadyExists = false;
-                    try { folderAlreadyExists = parallel::getItemType(targetPath, singleThread_) == AFS::ItemType::FOLDER; } /*throw FileError*/ catch (FileError&) {}
+                    try { folderAlreadyExists = AFS::getItemType(targetPath) == AFS::ItemType::FOLDER; } /*throw FileError*/ catch (FileError&) {}
                     //previous exception is more relevant; good enough? https://freefilesync.org/forum/viewtopic.php?t=5266
 
                     if (!folderAlreadyExists)
@@ -1986,22 +2524,26 @@ void FolderPairSyncer::synchronizeFolderInt(FolderPair& folder, SyncOperation sy
                 statReporter.reportDelta(1, 0);
 
                 //update FolderPair
+                std::lock_guard dummy(lockHierarchy_);
                 folder.setSyncedTo<sideTrg>(folder.getItemName<sideSrc>(),
                                             false, //isSymlinkTrg
                                             folder.isFollowedSymlink<sideSrc>());
             }
             else //source deleted meanwhile...
             {
-                //attention when fixing statistics due to missing folder: child items may be scheduled for move, so deletion will have move-references flip back to copy + delete!
-                const SyncStatistics statsBefore(folder.base()); //=> don't bother considering move operations, just calculate over the whole tree
-                folder.refSubFiles  ().clear(); //
-                folder.refSubLinks  ().clear(); //update FolderPair
-                folder.refSubFolders().clear(); //
-                folder.removeObject<sideSrc>(); //
-                const SyncStatistics statsAfter(folder.base());
+                {
+                    std::lock_guard dummy(lockHierarchy_);
+                    //attention when fixing statistics due to missing folder: child items may be scheduled for move, so deletion will have move-references flip back to copy + delete!
+                    const SyncStatistics statsBefore(folder.base()); //=> don't bother considering move operations, just calculate over the whole tree
+                    folder.refSubFiles  ().clear(); //
+                    folder.refSubLinks  ().clear(); //update FolderPair
+                    folder.refSubFolders().clear(); //
+                    folder.removeObject<sideSrc>(); //
+                    const SyncStatistics statsAfter(folder.base());
 
-                acb_.updateDataProcessed(1, 0); //even if the source item does not exist anymore, significant I/O work was done => report
-                acb_.updateDataTotal(getCUD(statsAfter) - getCUD(statsBefore) + 1, statsAfter.getBytesToProcess() - statsBefore.getBytesToProcess()); //noexcept
+                    acb_.updateDataProcessed(1, 0); //even if the source item does not exist anymore, significant I/O work was done => report
+                    acb_.updateDataTotal(getCUD(statsAfter) - getCUD(statsBefore) + 1, statsAfter.getBytesToProcess() - statsBefore.getBytesToProcess()); //noexcept
+                }
 
                 reportInfo(txtSourceItemNotFound_, AFS::getDisplayPath(folder.getAbstractPath<sideSrc>())); //throw ThreadInterruption
             }
@@ -2012,13 +2554,18 @@ void FolderPairSyncer::synchronizeFolderInt(FolderPair& folder, SyncOperation sy
         case SO_DELETE_RIGHT:
             reportInfo(delHandlerTrg.getTxtRemovingFolder(), AFS::getDisplayPath(folder.getAbstractPath<sideTrg>())); //throw ThreadInterruption
             {
-                const SyncStatistics subStats(folder); //counts sub-objects only!
+                const SyncStatistics subStats = [&]
+                {
+                    std::lock_guard dummy(lockHierarchy_); //sub-objects might reference move items outside this folder
+                    return SyncStatistics(folder); //counts sub-objects only!
+                }();
                 AsyncItemStatReporter statReporter(1 + getCUD(subStats), subStats.getBytesToProcess(), acb_);
 
-                delHandlerTrg.removeDirWithCallback(folder.getAbstractPath<sideTrg>(), folder.getRelativePath<sideTrg>(), statReporter, singleThread_); //throw FileError, X
+                delHandlerTrg.removeDirWithCallback(folder.getAbstractPath<sideTrg>(), folder.getRelativePath<sideTrg>(), statReporter); //throw FileError, X
 
                 //TODO: implement parallel folder deletion
 
+                std::lock_guard dummy(lockHierarchy_);
                 folder.refSubFiles  ().clear(); //
                 folder.refSubLinks  ().clear(); //update FolderPair
                 folder.refSubFolders().clear(); //
@@ -2036,8 +2583,8 @@ void FolderPairSyncer::synchronizeFolderInt(FolderPair& folder, SyncOperation sy
 
                 if (getUnicodeNormalForm(folder.getItemName<sideTrg>()) !=
                     getUnicodeNormalForm(folder.getItemName<sideSrc>())) //have difference in case?
-                    parallel::moveAndRenameItem(folder.getAbstractPath<sideTrg>(), //throw FileError, (ErrorDifferentVolume)
-                                                AFS::appendRelPath(folder.parent().getAbstractPath<sideTrg>(), folder.getItemName<sideSrc>()), singleThread_);
+                    AFS::moveAndRenameItem(folder.getAbstractPath<sideTrg>(), //throw FileError, (ErrorDifferentVolume)
+                                           AFS::appendRelPath(folder.parent().getAbstractPath<sideTrg>(), folder.getItemName<sideSrc>()));
                 else
                     assert(false);
                 //copyFileTimes -> useless: modification time changes with each child-object creation/deletion
@@ -2045,6 +2592,7 @@ void FolderPairSyncer::synchronizeFolderInt(FolderPair& folder, SyncOperation sy
                 statReporter.reportDelta(1, 0);
 
                 //-> both sides *should* be completely equal now...
+                std::lock_guard dummy(lockHierarchy_);
                 folder.setSyncedTo<sideTrg>(folder.getItemName<sideSrc>(),
                                             folder.isFollowedSymlink<sideTrg>(),
                                             folder.isFollowedSymlink<sideSrc>());
@@ -2074,39 +2622,44 @@ AFS::FileCopyResult FolderPairSyncer::copyFileWithCallback(const FileDescriptor&
     const AbstractPath& sourcePath = sourceDescr.path;
     const AFS::StreamAttributes sourceAttr{ sourceDescr.attr.modTime, sourceDescr.attr.fileSize, sourceDescr.attr.fileId };
 
-    auto copyOperation = [this, &sourceAttr, &targetPath, &onDeleteTargetFile, &statReporter](const AbstractPath& sourcePathTmp)
+    //don't let threadCount workers each run threadCount stripes on the same device
+    const size_t stripeCountMax = stripedCopyMinSize_ > 0 && sourceAttr.fileSize >= stripedCopyMinSize_ ?
+                                  std::min(stripeCount_, ioLimiter_.getParallelWrites(targetPath.afsDevice)) : 1;
+
+    //one write slot per stripe: the first one is already held by the caller
+    const size_t stripeWritesExtra = stripeCountMax > 1 ? ioLimiter_.tryAcquireWrites(targetPath.afsDevice, stripeCountMax - 1) : 0;
+    ZEN_ON_SCOPE_EXIT(ioLimiter_.releaseWrites(targetPath.afsDevice, stripeWritesExtra));
+    const size_t stripeCount = 1 + stripeWritesExtra;
+
+    auto copyOperation = [this, &sourceAttr, &targetPath, stripeCount, &onDeleteTargetFile, &statReporter](const AbstractPath& sourcePathTmp)
     {
         //target existing after onDeleteTargetFile(): undefined behavior! (fail/overwrite/auto-rename)
-        const AFS::FileCopyResult result = parallel::copyFileTransactional(sourcePathTmp, sourceAttr, //throw FileError, ErrorFileLocked, ThreadInterruption, X
-                                                                           targetPath,
-                                                                           copyFilePermissions_,
-                                                                           failSafeFileCopy_, [&]
+        const AFS::FileCopyResult result = AFS::copyFileTransactional(sourcePathTmp, sourceAttr, //throw FileError, ErrorFileLocked, ThreadInterruption, X
+                                                                      targetPath,
+                                                                      copyFilePermissions_,
+                                                                      failSafeFileCopy_,
+                                                                      stripeCount, [&]
         {
-            if (onDeleteTargetFile) //running *outside* singleThread_ lock! => onDeleteTargetFile-callback expects lock being held:
-            {
-                std::lock_guard dummy(singleThread_);
+            if (onDeleteTargetFile)
                 onDeleteTargetFile(); //throw X
-            }
         },
-        [&](int64_t bytesDelta) //callback runs *outside* singleThread_ lock! => fine
+        [&](int64_t bytesDelta)
         {
             statReporter.reportDelta(0, bytesDelta);
             interruptionPoint(); //throw ThreadInterruption
-        },
-        singleThread_);
+        });
 
         //#################### Verification #############################
         if (verifyCopiedFiles_)
         {
-            ZEN_ON_SCOPE_FAIL(try { parallel::removeFilePlain(targetPath, singleThread_); }
+            ZEN_ON_SCOPE_FAIL(try { AFS::removeFilePlain(targetPath); }
             catch (FileError&) {}); //delete target if verification fails
 
             reportInfo(txtVerifyingFile_, AFS::getDisplayPath(targetPath)); //throw ThreadInterruption
 
-            //callback runs *outside* singleThread_ lock! => fine
             auto verifyCallback = [&](int64_t bytesDelta) { interruptionPoint(); }; //throw ThreadInterruption
 
-            parallel::verifyFiles(sourcePathTmp, targetPath, verifyCallback, singleThread_); //throw FileError, ThreadInterruption
+            verifyFiles(sourcePathTmp, targetPath, verifyCallback); //throw FileError, ThreadInterruption
         }
         //#################### /Verification #############################
 
@@ -2214,10 +2767,13 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                       bool copyLockedFiles,
                       bool copyFilePermissions,
                       bool failSafeFileCopy,
+                      int stripedCopyMinSizeMB,
+                      const IOProfile& streamingIO,
                       bool runWithBackgroundPriority,
                       const std::vector<FolderPairSyncCfg>& syncConfig,
                       FolderComparison& folderCmp,
                       const std::map<AfsDevice, size_t>& deviceParallelOps,
+                      const std::map<AfsDevice, size_t>& deviceParallelWrites,
                       WarningDialogs& warnings,
                       ProcessCallback& callback)
 {
@@ -2261,6 +2817,9 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
             callback.reportInfo(e.toString()); //throw X
         }
 
+    setNativeStreamingProfile(streamingIO);
+    ZEN_ON_SCOPE_EXIT(setNativeStreamingProfile(IOProfile()));
+
     //prevent operating system going into sleep state
     std::unique_ptr<PreventStandby> noStandby;
     try
@@ -2560,13 +3119,63 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
 
     //-------------------end of basic checks------------------------------------------
 
-    std::vector<FileError> errorsModTime; //show all warnings as a single message
+    Protected<std::vector<FileError>> errorsModTime; //show all warnings as a single message
 
     std::set<VersioningLimitFolder> versionLimitFolders;
 
+    std::mutex lockHierarchy; //file_hierarchy model: shared by all folder pairs
+
+    DeviceIoLimiter ioLimiter(deviceParallelOps, deviceParallelWrites); //shared by all folder pairs
+
     try
     {
-        //loop through all directory pairs
+        struct FolderPairJob
+        {
+            BaseFolderPair& baseFolder;
+            const FolderPairSyncCfg& folderPairCfg;
+            const FolderPairJobType jobType;
+            const AbstractPath versioningFolderPath;
+
+            std::unique_ptr<DeletionHandler> delHandlerL;     //
+            std::unique_ptr<DeletionHandler> delHandlerR;     //FolderPairJobType::PROCESS only
+            std::optional<FolderPairSyncer::SyncCtx> syncCtx; //
+            bool finalized = false;
+        };
+        std::vector<FolderPairJob> jobs;
+        jobs.reserve(folderCmp.size());
+
+        //sync aborted => (try to) clean up and update synchronization database for folder pairs not yet finalized
+        auto guardJobs = makeGuard<ScopeGuardRunMode::ON_FAIL>([&]
+        {
+            for (FolderPairJob& job : jobs)
+                if (!job.finalized)
+                {
+                    //may block heavily, but still do not allow user callback:
+                    //-> avoid throwing user cancel exception again, leading to incomplete clean-up!
+                    for (DeletionHandler* delHandler : { job.delHandlerL.get(), job.delHandlerR.get() })
+                        if (delHandler)
+                            try
+                            {
+                                delHandler->tryCleanup(callback, false /*allowCallbackException*/); //throw FileError, (throw X)
+                            }
+                            catch (FileError&) {}
+                            catch (...) { assert(false); } //what is this?
+
+                    //guarantee removal of invalid entries (where element is empty on both sides)
+                    if (job.jobType == FolderPairJobType::PROCESS)
+                        BaseFolderPair::removeEmpty(job.baseFolder);
+
+                    try
+                    {
+                        if (job.folderPairCfg.saveSyncDB)
+                            saveLastSynchronousState(job.baseFolder, //throw FileError
+                            [&](const std::wstring& statusMsg) { try { callback.reportStatus(statusMsg); /*throw X*/} catch (...) {}});
+                    }
+                    catch (FileError&) {}
+                }
+        });
+
+        //prepare all directory pairs: runs on main thread (user interaction via callback)
         for (auto itBase = begin(folderCmp); itBase != end(folderCmp); ++itBase)
         {
             BaseFolderPair& baseFolder = *itBase;
@@ -2594,26 +3203,11 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                     !createBaseFolder<RIGHT_SIDE>(baseFolder, copyFilePermissions, callback))   //
                     continue;
 
-            //------------------------------------------------------------------------------------------
-            //execute synchronization recursively
-
-            //update synchronization database in case of errors:
-            auto guardDbSave = makeGuard<ScopeGuardRunMode::ON_FAIL>([&]
-            {
-                try
-                {
-                    if (folderPairCfg.saveSyncDB)
-                        saveLastSynchronousState(baseFolder, //throw FileError
-                        [&](const std::wstring& statusMsg) { try { callback.reportStatus(statusMsg); /*throw X*/} catch (...) {}});
-                }
-                catch (FileError&) {}
-            });
+            jobs.push_back({ baseFolder, folderPairCfg, jobType[folderIndex], createAbstractPath(folderPairCfg.versioningFolderPhrase) });
+            FolderPairJob& job = jobs.back();
 
-            if (jobType[folderIndex] == FolderPairJobType::PROCESS)
+            if (job.jobType == FolderPairJobType::PROCESS)
             {
-                //guarantee removal of invalid entries (where element is empty on both sides)
-                ZEN_ON_SCOPE_EXIT(BaseFolderPair::removeEmpty(baseFolder));
-
                 bool copyPermissionsFp = false;
                 tryReportingError([&]
                 {
@@ -2636,81 +3230,153 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
                     }
                     return folderPairCfg.handleDeletion;
                 };
-                const AbstractPath versioningFolderPath = createAbstractPath(folderPairCfg.versioningFolderPhrase);
-
-                DeletionHandler delHandlerL(baseFolder.getAbstractPath<LEFT_SIDE>(),
-                                            getEffectiveDeletionPolicy(baseFolder.getAbstractPath<LEFT_SIDE>()),
-                                            versioningFolderPath,
-                                            folderPairCfg.versioningStyle,
-                                            std::chrono::system_clock::to_time_t(syncStartTime));
-
-                DeletionHandler delHandlerR(baseFolder.getAbstractPath<RIGHT_SIDE>(),
-                                            getEffectiveDeletionPolicy(baseFolder.getAbstractPath<RIGHT_SIDE>()),
-                                            versioningFolderPath,
-                                            folderPairCfg.versioningStyle,
-                                            std::chrono::system_clock::to_time_t(syncStartTime));
-
-                //always (try to) clean up, even if synchronization is aborted!
-                ZEN_ON_SCOPE_EXIT(
-                    //may block heavily, but still do not allow user callback:
-                    //-> avoid throwing user cancel exception again, leading to incomplete clean-up!
-                    try
-                {
-                    delHandlerL.tryCleanup(callback, false /*allowCallbackException*/); //throw FileError, (throw X)
-                }
-                catch (FileError&) {}
-                catch (...) { assert(false); } //what is this?
-                try
-                {
-                    delHandlerR.tryCleanup(callback, false /*allowCallbackException*/); //throw FileError, (throw X)
-                }
-                catch (FileError&) {}
-                catch (...) { assert(false); } //what is this?
-                );
+
+                job.delHandlerL = std::make_unique<DeletionHandler>(baseFolder.getAbstractPath<LEFT_SIDE>(),
+                                                                    getEffectiveDeletionPolicy(baseFolder.getAbstractPath<LEFT_SIDE>()),
+                                                                    job.versioningFolderPath,
+                                                                    folderPairCfg.versioningStyle,
+                                                                    std::chrono::system_clock::to_time_t(syncStartTime));
+
+                job.delHandlerR = std::make_unique<DeletionHandler>(baseFolder.getAbstractPath<RIGHT_SIDE>(),
+                                                                    getEffectiveDeletionPolicy(baseFolder.getAbstractPath<RIGHT_SIDE>()),
+                                                                    job.versioningFolderPath,
+                                                                    folderPairCfg.versioningStyle,
+                                                                    std::chrono::system_clock::to_time_t(syncStartTime));
 
                 size_t parallelOps = std::max(getDeviceParallelOps(deviceParallelOps, baseFolder.getAbstractPath< LEFT_SIDE>().afsDevice),
                                               getDeviceParallelOps(deviceParallelOps, baseFolder.getAbstractPath<RIGHT_SIDE>().afsDevice));
                 if (folderPairCfg.handleDeletion == DeletionPolicy::VERSIONING)
-                    parallelOps = std::max(parallelOps, getDeviceParallelOps(deviceParallelOps, versioningFolderPath.afsDevice));
+                    parallelOps = std::max(parallelOps, getDeviceParallelOps(deviceParallelOps, job.versioningFolderPath.afsDevice));
 
-                FolderPairSyncer::SyncCtx syncCtx =
+                job.syncCtx.emplace(FolderPairSyncer::SyncCtx
                 {
                     verifyCopiedFiles, copyPermissionsFp, failSafeFileCopy,
+                    stripedCopyMinSizeMB > 0 ? static_cast<uint64_t>(stripedCopyMinSizeMB) * 1024 * 1024 : 0,
                     errorsModTime,
-                    delHandlerL, delHandlerR,
+                    lockHierarchy,
+                    ioLimiter,
+                    *job.delHandlerL, *job.delHandlerR,
                     parallelOps
-                };
-                FolderPairSyncer::runSync(syncCtx, baseFolder, callback);
+                });
+            }
+        }
 
+        //------------------------------------------------------------------------------------------
+        //execute synchronization recursively: folder pairs in parallel
+        {
+            //folder pairs with dependent base folders must wait for each other (in configuration order)
+            //=> nested base folders are not synchronized concurrently; I/O on a shared device is throttled by "ioLimiter" instead
+            //=> don't serialize by AfsDevice: native paths outside of /mnt, /media, /run/media all share root device "/"!
+            auto getAccessedFolders = [](const FolderPairJob& job)
+            {
+                std::vector<std::pair<AbstractPath, const PathFilter*>> folders;
+                for (const AbstractPath& folderPath : { job.baseFolder.getAbstractPath<LEFT_SIDE>(), job.baseFolder.getAbstractPath<RIGHT_SIDE>() })
+                    if (!AFS::isNullPath(folderPath))
+                        folders.emplace_back(folderPath, &job.baseFolder.getFilter());
+
+                static const NullFilter nullFilter;
+                if (job.folderPairCfg.handleDeletion == DeletionPolicy::VERSIONING && !AFS::isNullPath(job.versioningFolderPath))
+                    folders.emplace_back(job.versioningFolderPath, &nullFilter);
+                return folders;
+            };
+            auto haveSyncDependency = [&](const FolderPairJob& job1, const FolderPairJob& job2)
+            {
+                for (const auto& [folderPath1, filter1] : getAccessedFolders(job1))
+                    for (const auto& [folderPath2, filter2] : getAccessedFolders(job2))
+                        if (getPathDependency(folderPath1, *filter1, folderPath2, *filter2))
+                            return true;
+                return false;
+            };
+
+            std::vector<std::vector<size_t>> jobPredecessors(jobs.size());
+            size_t jobsPending = 0;
+
+            for (size_t jobIdx = 0; jobIdx < jobs.size(); ++jobIdx)
+                if (jobs[jobIdx].syncCtx)
+                {
+                    ++jobsPending;
+                    for (size_t jobIdxPrev = 0; jobIdxPrev < jobIdx; ++jobIdxPrev)
+                        if (jobs[jobIdxPrev].syncCtx && haveSyncDependency(jobs[jobIdx], jobs[jobIdxPrev]))
+                            jobPredecessors[jobIdx].push_back(jobIdxPrev);
+                }
+
+            if (jobsPending > 0)
+            {
+                AsyncCallback acb;                                       //
+                std::mutex lockJobs;                                     //
+                std::condition_variable conditionJobDone;                //manage life time: enclose InterruptibleThread's!!!
+                std::vector<char /*bool*/> jobDone(jobs.size(), false);  //
+
+                std::vector<InterruptibleThread> pairThreads;
+                ZEN_ON_SCOPE_EXIT( for (InterruptibleThread& pt : pairThreads) pt.join     (); ); //
+                ZEN_ON_SCOPE_EXIT( for (InterruptibleThread& pt : pairThreads) pt.interrupt(); ); //interrupt all first, then join
+
+                for (size_t jobIdx = 0; jobIdx < jobs.size(); ++jobIdx)
+                    if (jobs[jobIdx].syncCtx)
+                        pairThreads.emplace_back([jobIdx, &job = jobs[jobIdx], &predecessors = jobPredecessors[jobIdx],
+                                                  &acb, &lockJobs, &conditionJobDone, &jobDone, &jobsPending]
+                    {
+                        setCurrentThreadName(("Sync Folder Pair[" + numberTo<std::string>(jobIdx) + "]").c_str());
+                        {
+                            std::unique_lock dummy(lockJobs);
+                            interruptibleWait(conditionJobDone, dummy, [&] //throw ThreadInterruption
+                            {
+                                return std::all_of(predecessors.begin(), predecessors.end(), [&](size_t jobIdxPrev) { return jobDone[jobIdxPrev] != 0; });
+                            });
+                        }
+
+                        FolderPairSyncer::runSync(*job.syncCtx, job.baseFolder, acb, jobIdx /*statusPrio*/); //throw ThreadInterruption
+
+                        {
+                            std::lock_guard dummy(lockJobs);
+                            jobDone[jobIdx] = true;
+                            if (--jobsPending == 0)
+                                acb.notifyAllDone(); //noexcept
+                        }
+                        conditionJobDone.notify_all();
+                    });
+
+                acb.waitUntilDone(UI_UPDATE_INTERVAL / 2 /*every ~50 ms*/, callback); //throw X
+            }
+        }
+
+        //------------------------------------------------------------------------------------------
+        //finalize directory pairs: runs on main thread (user interaction via callback)
+        for (FolderPairJob& job : jobs)
+        {
+            if (job.jobType == FolderPairJobType::PROCESS)
+            {
                 //(try to gracefully) cleanup temporary Recycle Bin folders and versioning -> will be done in ~DeletionHandler anyway...
-                tryReportingError([&] { delHandlerL.tryCleanup(callback, true /*allowCallbackException*/); /*throw FileError*/}, callback); //throw X
-                tryReportingError([&] { delHandlerR.tryCleanup(callback, true                           ); /*throw FileError*/}, callback); //throw X
+                tryReportingError([&] { job.delHandlerL->tryCleanup(callback, true /*allowCallbackException*/); /*throw FileError*/}, callback); //throw X
+                tryReportingError([&] { job.delHandlerR->tryCleanup(callback, true                           ); /*throw FileError*/}, callback); //throw X
 
-                if (folderPairCfg.handleDeletion == DeletionPolicy::VERSIONING &&
-                    folderPairCfg.versioningStyle != VersioningStyle::REPLACE)
+                if (job.folderPairCfg.handleDeletion == DeletionPolicy::VERSIONING &&
+                    job.folderPairCfg.versioningStyle != VersioningStyle::REPLACE)
                     versionLimitFolders.insert(
                 {
-                    versioningFolderPath,
-                    folderPairCfg.versionMaxAgeDays,
-                    folderPairCfg.versionCountMin,
-                    folderPairCfg.versionCountMax
+                    job.versioningFolderPath,
+                    job.folderPairCfg.versionMaxAgeDays,
+                    job.folderPairCfg.versionCountMin,
+                    job.folderPairCfg.versionCountMax
                 });
+
+                //guarantee removal of invalid entries (where element is empty on both sides)
+                BaseFolderPair::removeEmpty(job.baseFolder);
             }
 
             //(try to gracefully) write database file
-            if (folderPairCfg.saveSyncDB)
+            if (job.folderPairCfg.saveSyncDB)
             {
                 callback.reportStatus(_("Generating database...")); //throw X
                 callback.forceUiRefresh(); //throw X
 
                 tryReportingError([&]
                 {
-                    saveLastSynchronousState(baseFolder, //throw FileError, X
+                    saveLastSynchronousState(job.baseFolder, //throw FileError, X
                     [&](const std::wstring& statusMsg) { callback.reportStatus(statusMsg); /*throw X*/});
                 }, callback); //throw X
-
-                guardDbSave.dismiss(); //[!] after "graceful" try: user might have cancelled during DB write: ensure DB is still written
             }
+            job.finalized = true; //[!] after "graceful" try: user might have cancelled during DB write: ensure DB is still written
         }
 
         //-----------------------------------------------------------------------------------------------------
@@ -2722,10 +3388,11 @@ void fff::synchronize(const std::chrono::system_clock::time_point& syncStartTime
         //TODO: mod time warnings are not shown if user cancelled sync before batch-reporting the warnings: problem?
 
         //show errors when setting modification time: warning, not an error
-        if (!errorsModTime.empty())
+        const std::vector<FileError> errorsModTimeAll = errorsModTime.access([](const std::vector<FileError>& errors) { return errors; });
+        if (!errorsModTimeAll.empty())
         {
             std::wstring msg;
-            for (const FileError& e : errorsModTime)
+            for (const FileError& e : errorsModTimeAll)
             {
                 std::wstring singleMsg = replaceCpy(e.toString(), L"\n\n", L"\n");
                 msg += singleMsg + L"\n\n";
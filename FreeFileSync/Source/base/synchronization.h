@@ -91,10 +91,13 @@ void synchronize(const std::chrono::system_clock::time_point& syncStartTime,
                  bool copyLockedFiles,
                  bool copyFilePermissions,
                  bool failSafeFileCopy,
+                 int stripedCopyMinSizeMB, //copy files of at least this size as parallel stripes; <= 0: disabled
+                 const zen::IOProfile& streamingIO, //for native folders
                  bool runWithBackgroundPriority,
                  const std::vector<FolderPairSyncCfg>& syncConfig, //CONTRACT: syncConfig and folderCmp correspond row-wise!
                  FolderComparison& folderCmp,                      //
                  const std::map<AfsDevice, size_t>& deviceParallelOps,
+                 const std::map<AfsDevice, size_t>& deviceParallelWrites, //sync only: explicit write limits
                  WarningDialogs& warnings,
                  ProcessCallback& callback);
 }
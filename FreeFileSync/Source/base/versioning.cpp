@@ -197,6 +197,7 @@ void FileVersioner::revisionFileImpl(const FileDescriptor& fileDescr, const Zstr
         /*const AFS::FileCopyResult result =*/ AFS::copyFileTransactional(filePath, fileAttr, targetPath, //throw FileError, ErrorFileLocked, X
                                                                           false, //copyFilePermissions
                                                                           false,  //transactionalCopy: not needed for versioning! partial copy will be overwritten next time
+                                                                          1,      //stripeCount
                                                                           nullptr /*onDeleteTargetFile*/, notifyUnbufferedIO);
         //result.errorModTime? => irrelevant for versioning!
     });
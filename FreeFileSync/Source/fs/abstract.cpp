@@ -155,6 +155,7 @@ AFS::FileCopyResult AFS::copyFileTransactional(const AbstractPath& apSource, con
                                                const AbstractPath& apTarget,
                                                bool copyFilePermissions,
                                                bool transactionalCopy,
+                                               size_t stripeCount,
                                                const std::function<void()>& onDeleteTargetFile,
                                                const IOCallback& notifyUnbufferedIO /*throw X*/)
 {
@@ -163,7 +164,7 @@ AFS::FileCopyResult AFS::copyFileTransactional(const AbstractPath& apSource, con
         //caveat: typeid returns static type for pointers, dynamic type for references!!!
         if (typeid(apSource.afsDevice.ref()) == typeid(apTargetTmp.afsDevice.ref()))
             return apSource.afsDevice.ref().copyFileForSameAfsType(apSource.afsPath, attrSource,
-                                                                   apTargetTmp, copyFilePermissions, notifyUnbufferedIO); //throw FileError, ErrorFileLocked, X
+                                                                   apTargetTmp, copyFilePermissions, stripeCount, notifyUnbufferedIO); //throw FileError, ErrorFileLocked, X
         //target existing: undefined behavior! (fail/overwrite/auto-rename)
 
         //fall back to stream-based file copy:
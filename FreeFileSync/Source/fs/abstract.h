@@ -178,6 +178,12 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
     static std::unique_ptr<InputStream> getInputStream(const AbstractPath& ap, const zen::IOCallback& notifyUnbufferedIO /*throw X*/) //throw FileError, ErrorFileLocked
     { return ap.afsDevice.ref().getInputStream(ap.afsPath, notifyUnbufferedIO); }
 
+    //read "blockSize" bytes at each offset (fewer at end of file) without streaming the whole file
+    //returns std::nullopt if device has no cheap random access => use getInputStream() instead
+    static std::optional<std::vector<std::byte>> readFileBlocks(const AbstractPath& ap, const std::vector<uint64_t>& offsets, size_t blockSize, //throw FileError, ErrorFileLocked, X
+                                                                const zen::IOCallback& notifyUnbufferedIO /*throw X*/)
+    { return ap.afsDevice.ref().readFileBlocks(ap.afsPath, offsets, blockSize, notifyUnbufferedIO); }
+
     //target existing: undefined behavior! (fail/overwrite/auto-rename)
     static std::unique_ptr<OutputStream> getOutputStream(const AbstractPath& ap, //throw FileError
                                                          std::optional<uint64_t> streamSize,
@@ -270,6 +276,7 @@ struct AbstractFileSystem //THREAD-SAFETY: "const" member functions must model t
                                                 const AbstractPath& apTarget,
                                                 bool copyFilePermissions,
                                                 bool transactionalCopy,
+                                                size_t stripeCount, //> 1: copy large files as disjoint byte ranges in parallel (if supported by AFS)
                                                 //if target is existing user *must* implement deletion to avoid undefined behavior
                                                 //if transactionalCopy == true, full read access on source had been proven at this point, so it's safe to delete it.
                                                 const std::function<void()>& onDeleteTargetFile /*throw X*/,
@@ -351,6 +358,9 @@ private:
     //----------------------------------------------------------------------------------------------------------------
     virtual std::unique_ptr<InputStream> getInputStream(const AfsPath& afsPath, const zen::IOCallback& notifyUnbufferedIO /*throw X*/) const = 0; //throw FileError, ErrorFileLocked
 
+    virtual std::optional<std::vector<std::byte>> readFileBlocks(const AfsPath& afsPath, const std::vector<uint64_t>& offsets, size_t blockSize, //throw FileError, ErrorFileLocked, X
+                                                                 const zen::IOCallback& notifyUnbufferedIO /*throw X*/) const { return {}; }
+
     //target existing: undefined behavior! (fail/overwrite/auto-rename)
     virtual std::unique_ptr<OutputStreamImpl> getOutputStream(const AfsPath& afsPath, //throw FileError
                                                               std::optional<uint64_t> streamSize,
@@ -367,7 +377,7 @@ private:
     //symlink handling: follow link!
     //target existing: undefined behavior! (fail/overwrite/auto-rename)
     virtual FileCopyResult copyFileForSameAfsType(const AfsPath& afsPathSource, const StreamAttributes& attrSource, //throw FileError, ErrorFileLocked, X
-                                                  const AbstractPath& apTarget, bool copyFilePermissions,
+                                                  const AbstractPath& apTarget, bool copyFilePermissions, size_t stripeCount,
                                                   //accummulated delta != file size! consider ADS, sparse, compressed files
                                                   const zen::IOCallback& notifyUnbufferedIO /*throw X*/) const = 0;
 
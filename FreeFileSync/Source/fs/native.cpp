@@ -14,6 +14,8 @@
 #include <zen/thread.h>
 #include <zen/guid.h>
 #include <zen/crc.h>
+#include <zen/statx_batch.h>
+#include <zen/globals.h>
 #include "abstract_impl.h"
 #include "../base/resolve_path.h"
 #include "../base/icon_loader.h"
@@ -22,7 +24,11 @@
     #include <cstddef> //offsetof
     #include <sys/stat.h>
     #include <dirent.h>
-    #include <fcntl.h> //fallocate, fcntl
+    #include <fcntl.h> //fallocate, fcntl, open
+    #include <unistd.h> //syscall
+    #include <sys/syscall.h> //SYS_getdents64
+    #include <sys/sysmacros.h> //makedev
+    #include <sys/vfs.h> //statfs
 
 using namespace zen;
 using namespace fff;
@@ -35,6 +41,17 @@ void initComForThread() //throw FileError
 {
 }
 
+
+Global<const IOProfile> globalStreamingProfile; //set for the duration of a sync; default: OS-buffered
+
+
+IOProfile getStreamingProfile()
+{
+    if (std::shared_ptr<const IOProfile> profile = globalStreamingProfile.get())
+        return *profile;
+    return IOProfile();
+}
+
 //====================================================================================================
 //====================================================================================================
 
@@ -54,132 +71,289 @@ struct FsItemRaw
 {
     Zstring itemName;
     Zstring itemPath;
+    int statxFlags; //device-specific: see getDeviceStatxFlags()
 };
-std::vector<FsItemRaw> getDirContentFlat(const Zstring& dirPath) //throw FileError
+
+
+struct DirContentRaw //item names + types of a single directory
+{
+    Zstring dirPath;
+    int statxFlags = 0; //device-specific: see getDeviceStatxFlags()
+    std::vector<char> nameBuf; //all item names in one contiguous buffer, each null-terminated
+    struct Item
+    {
+        size_t nameOffset; //into nameBuf
+        unsigned char dirType; //DT_DIR, DT_LNK, DT_REG, ... or DT_UNKNOWN if not supported by file system (e.g. old XFS, ReiserFS)
+    };
+    std::vector<Item> items;
+
+    const char* getItemName(const Item& item) const { return &nameBuf[item.nameOffset]; }
+};
+
+
+//there is no glibc wrapper before 2.30 => use our own definition: http://man7.org/linux/man-pages/man2/getdents.2.html
+struct LinuxDirent64
+{
+    uint64_t       d_ino;
+    int64_t        d_off;
+    unsigned short d_reclen;
+    unsigned char  d_type;
+    //char         d_name[]; //null-terminated
+};
+const size_t DIR_NAME_OFFSET = offsetof(LinuxDirent64, d_type) + sizeof(LinuxDirent64::d_type);
+
+const size_t GETDENTS_BUFFER_SIZE = 64 * 1024; //stay below glibc's mmap threshold (128 KB) => no syscall for allocation
+
+
+DirContentRaw getDirContentFlat(const Zstring& dirPath, int statxFlags) //throw FileError
 {
     //no need to check for endless recursion:
     //1. Linux has a fixed limit on the number of symbolic links in a path
     //2. fails with "too many open files" or "path too long" before reaching stack overflow
 
-    DIR* folder = ::opendir(dirPath.c_str()); //directory must NOT end with path separator, except "/"
-    if (!folder)
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(dirPath)), L"opendir");
-    ZEN_ON_SCOPE_EXIT(::closedir(folder)); //never close nullptr handles! -> crash
+    const int fdDir = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC); //directory must NOT end with path separator, except "/"
+    if (fdDir == -1)
+        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot open directory %x."), L"%x", fmtPath(dirPath)), L"open");
+    ZEN_ON_SCOPE_EXIT(::close(fdDir));
+
+    /*  readdir() hides the getdents64() batching behind one call per item and buffers only 32 KB internally
+        => read large batches directly and keep d_type: saves lstat() for folders (see GetItemDetailsBatch)
+
+        thread-safety: no shared state (unlike DIR*) => fine for concurrent calls on different directories */
+    std::vector<std::byte> buffer(GETDENTS_BUFFER_SIZE); //operator new: aligned for LinuxDirent64
 
-    std::vector<FsItemRaw> output;
+    DirContentRaw output;
+    output.dirPath    = dirPath;
+    output.statxFlags = statxFlags;
     for (;;)
     {
-        /*
-            Linux:
-                http://man7.org/linux/man-pages/man3/readdir_r.3.html
-                "It is recommended that applications use readdir(3) instead of readdir_r"
-                "... in modern implementations (including the glibc implementation), concurrent calls to readdir(3) that specify different directory streams are thread-safe"
-
-            macOS:
-                - libc: readdir thread-safe already in code from 2000: https://opensource.apple.com/source/Libc/Libc-166/gen.subproj/readdir.c.auto.html
-                - and in the latest version from 2017:                 https://opensource.apple.com/source/Libc/Libc-1244.30.3/gen/FreeBSD/readdir.c.auto.html
-        */
-        errno = 0;
-        const struct ::dirent* dirEntry = ::readdir(folder);
-        if (!dirEntry)
-        {
-            if (errno == 0) //errno left unchanged => no more items
-                return output;
+        const long bytesRead = ::syscall(SYS_getdents64, fdDir, &buffer[0], buffer.size());
+        if (bytesRead < 0)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), L"getdents64");
+        //don't retry but restart dir traversal on error! https://blogs.msdn.microsoft.com/oldnewthing/20140612-00/?p=753/
+
+        if (bytesRead == 0) //no more items
+            return output;
 
-            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), L"readdir");
-            //don't retry but restart dir traversal on error! https://blogs.msdn.microsoft.com/oldnewthing/20140612-00/?p=753/
+        for (long pos = 0; pos < bytesRead;)
+        {
+            const auto& dirEntry = *reinterpret_cast<const LinuxDirent64*>(&buffer[pos]);
+            const char* itemNameRaw = reinterpret_cast<const char*>(&buffer[pos + DIR_NAME_OFFSET]);
+
+            if (dirEntry.d_reclen <= DIR_NAME_OFFSET || pos + dirEntry.d_reclen > bytesRead)
+                throw FileError(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), L"getdents64: Data corruption; invalid record length.");
+            pos += dirEntry.d_reclen;
+
+            //skip "." and ".."
+            if (itemNameRaw[0] == '.' &&
+                (itemNameRaw[1] == 0 || (itemNameRaw[1] == '.' && itemNameRaw[2] == 0)))
+                continue;
+
+            /*
+                Unicode normalization is file-system-dependent:
+
+                    OS                Accepts   Gives back
+                   ----------         -------   ----------
+                   macOS (HFS+)         all        NFD
+                   Linux                all      <input>
+                   Windows (NTFS, FAT)  all      <input>
+
+                some file systems return precomposed others decomposed UTF8: http://developer.apple.com/library/mac/#qa/qa1173/_index.html
+                      - OS X edit controls and text fields may return precomposed UTF as directly received by keyboard or decomposed UTF that was copy & pasted in!
+                      - Posix APIs require decomposed form: https://freefilesync.org/forum/viewtopic.php?t=2480
+
+                => General recommendation: always preserve input UNCHANGED (both unicode normalization and case sensitivity)
+                => normalize only when needed during string comparison
+
+                Create sample files on Linux: touch  decomposed-$'\x6f\xcc\x81'.txt
+                                              touch precomposed-$'\xc3\xb3'.txt
+
+                - SMB sharing case-sensitive or NFD file names is fundamentally broken on macOS:
+                    => the macOS SMB manager internally buffers file names as case-insensitive and NFC (= just like NTFS on Windows)
+                    => test: create SMB share from Linux => *boom* on macOS: "Error Code 2: No such file or directory [lstat]"
+                        or WORSE: folders "test" and "Test" *both* incorrectly return the content of one of the two
+            */
+            const size_t itemNameLen = strLength(itemNameRaw);
+            if (itemNameLen == 0)
+                throw FileError(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), L"getdents64: Data corruption; item with empty name.");
+
+            output.items.push_back({ output.nameBuf.size(), dirEntry.d_type });
+            output.nameBuf.insert(output.nameBuf.end(), itemNameRaw, itemNameRaw + itemNameLen + 1 /*include 0-termination*/);
         }
+    }
+}
+
+
+struct ItemDetailsRaw
+{
+    ItemType type;
+    time_t   modTime;   //number of seconds since Jan. 1st 1970 UTC
+    uint32_t modTimeNs; //nanosecond fraction of modTime: not (yet) part of AFS::FileInfo
+    uint64_t fileSize;  //unit: bytes!
+    FileId   fileId;
+};
+
+
+ItemDetailsRaw makeItemDetails(mode_t mode, time_t modTime, uint32_t modTimeNs, uint64_t fileSize, const FileId& fileId)
+{
+    if (S_ISLNK(mode)) //on Linux there is no distinction between file and directory symlinks!
+        return { ItemType::SYMLINK, modTime, modTimeNs, 0, fileId };
+
+    else if (S_ISDIR(mode)) //a directory
+        return { ItemType::FOLDER, modTime, modTimeNs, 0, fileId };
+
+    else //a file or named pipe, etc. => dont't check using S_ISREG(): see comment in file_traverser.cpp
+        return { ItemType::FILE, modTime, modTimeNs, fileSize, fileId };
+}
 
-        const char* itemNameRaw = dirEntry->d_name; //evaluate dirEntry *before* going into recursion
 
-        //skip "." and ".."
-        if (itemNameRaw[0] == '.' &&
-            (itemNameRaw[1] == 0 || (itemNameRaw[1] == '.' && itemNameRaw[2] == 0)))
-            continue;
+ItemDetailsRaw makeItemDetails(const struct ::stat& statData)
+{
+    return makeItemDetails(statData.st_mode, statData.st_mtim.tv_sec, static_cast<uint32_t>(statData.st_mtim.tv_nsec),
+                           makeUnsigned(statData.st_size), generateFileId(statData));
+}
 
-        /*
-            Unicode normalization is file-system-dependent:
 
-                OS                Accepts   Gives back
-               ----------         -------   ----------
-               macOS (HFS+)         all        NFD
-               Linux                all      <input>
-               Windows (NTFS, FAT)  all      <input>
+/*  statx() vs lstat():
+      - request only what we need: no permissions, owner, link count, atime, ctime, ...
+        => less work for network file systems (e.g. CIFS: no security descriptor needed)
+      - AT_STATX_DONT_SYNC: use cached attributes on NFS/CIFS instead of revalidating each item with the server
+        => decided once per device: see getDeviceStatxFlags()                                                     */
+const unsigned int STATX_MASK_FFS = STATX_TYPE | STATX_MTIME | STATX_SIZE | STATX_INO; //dev is always returned
 
-            some file systems return precomposed others decomposed UTF8: http://developer.apple.com/library/mac/#qa/qa1173/_index.html
-                  - OS X edit controls and text fields may return precomposed UTF as directly received by keyboard or decomposed UTF that was copy & pasted in!
-                  - Posix APIs require decomposed form: https://freefilesync.org/forum/viewtopic.php?t=2480
+std::atomic<bool> statxAvailable{ true }; //false: kernel < 4.11 or syscall blocked by seccomp filter (e.g. Docker < 18.04) => fall back to (l)stat()
 
-            => General recommendation: always preserve input UNCHANGED (both unicode normalization and case sensitivity)
-            => normalize only when needed during string comparison
 
-            Create sample files on Linux: touch  decomposed-$'\x6f\xcc\x81'.txt
-                                          touch precomposed-$'\xc3\xb3'.txt
+std::optional<ItemDetailsRaw> makeItemDetails(const struct ::statx& sx)
+{
+    if ((sx.stx_mask & STATX_MASK_FFS) != STATX_MASK_FFS) //file system might not support all fields => fall back to (l)stat()
+        return {};
 
-            - SMB sharing case-sensitive or NFD file names is fundamentally broken on macOS:
-                => the macOS SMB manager internally buffers file names as case-insensitive and NFC (= just like NTFS on Windows)
-                => test: create SMB share from Linux => *boom* on macOS: "Error Code 2: No such file or directory [lstat]"
-                    or WORSE: folders "test" and "Test" *both* incorrectly return the content of one of the two
-        */
-        const Zstring& itemName = itemNameRaw;
-        if (itemName.empty())
-            throw FileError(replaceCpy(_("Cannot read directory %x."), L"%x", fmtPath(dirPath)), L"readdir: Data corruption; item with empty name.");
+    return makeItemDetails(sx.stx_mode, sx.stx_mtime.tv_sec, sx.stx_mtime.tv_nsec, sx.stx_size,
+                           FileId(makedev(sx.stx_dev_major, sx.stx_dev_minor), sx.stx_ino)); //same as st_dev/st_ino => compatible with generateFileId()
+}
 
-        const Zstring& itemPath = appendSeparator(dirPath) + itemName;
 
-        output.push_back({ itemName, itemPath});
+std::optional<ItemDetailsRaw> tryGetItemDetailsStatx(int dirFd, const char* path, int flags) //throw SysError; no value if statx() is not available
+{
+    if (statxAvailable)
+    {
+        struct ::statx sx = {};
+        if (::statx(dirFd, path, flags, STATX_MASK_FFS, &sx) != 0)
+        {
+            if (errno != ENOSYS && errno != EPERM)
+                THROW_LAST_SYS_ERROR(L"statx");
+            statxAvailable = false;
+        }
+        else
+            return makeItemDetails(sx);
     }
+    return {};
 }
 
 
-struct ItemDetailsRaw
+//probe once per device (= traversal base folder) and apply to all items below, including nested mount points (AT_STATX_DONT_SYNC is a hint only)
+int getDeviceStatxFlags(const Zstring& folderPath) //noexcept
 {
-    ItemType type;
-    time_t   modTime; //number of seconds since Jan. 1st 1970 UTC
-    uint64_t fileSize; //unit: bytes!
-    FileId   fileId;
-};
-ItemDetailsRaw getItemDetails(const Zstring& itemPath) //throw FileError
+    struct ::stat statData = {};
+    if (::stat(folderPath.c_str(), &statData) != 0)
+        return 0; //let folder traversal report the error
+
+    static Protected<std::unordered_map<dev_t, int>> statxFlagsByDevice; //thread-safe: parallel traversal of different devices!
+
+    const std::optional<int> flagsBuf = statxFlagsByDevice.access([&](const std::unordered_map<dev_t, int>& flagsByDev) -> std::optional<int>
+    {
+        if (auto it = flagsByDev.find(statData.st_dev); it != flagsByDev.end())
+            return it->second;
+        return {};
+    });
+    if (flagsBuf)
+        return *flagsBuf;
+
+    int flags = 0;
+
+    struct ::statfs info = {};
+    if (::statfs(folderPath.c_str(), &info) == 0)
+        switch (info.f_type) //see <linux/magic.h>: not all values defined for older kernel headers
+        {
+            case 0x6969:     //NFS_SUPER_MAGIC
+            case 0x517B:     //SMB_SUPER_MAGIC
+            case 0xFF534D42: //CIFS_SUPER_MAGIC
+            case 0xFE534D42: //SMB2_SUPER_MAGIC
+                flags = AT_STATX_DONT_SYNC;
+                break;
+        }
+
+    statxFlagsByDevice.access([&](auto& flagsByDev) { flagsByDev.emplace(statData.st_dev, flags); });
+    return flags;
+}
+
+
+ItemDetailsRaw getItemDetails(const Zstring& itemPath, int statxFlags) //throw FileError
 {
+    try
+    {
+        if (std::optional<ItemDetailsRaw> details = tryGetItemDetailsStatx(AT_FDCWD, itemPath.c_str(), AT_SYMLINK_NOFOLLOW | statxFlags)) //throw SysError
+            return *details;
+    }
+    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(itemPath)), e.toString()); }
+
     struct ::stat statData = {};
     if (::lstat(itemPath.c_str(), &statData) != 0) //lstat() does not resolve symlinks
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(itemPath)), L"lstat");
 
-    if (S_ISLNK(statData.st_mode)) //on Linux there is no distinction between file and directory symlinks!
-        return { ItemType::SYMLINK, statData.st_mtime, 0, generateFileId(statData) };
-
-    else if (S_ISDIR(statData.st_mode)) //a directory
-        return { ItemType::FOLDER, statData.st_mtime, 0, generateFileId(statData) };
-
-    else //a file or named pipe, etc. => dont't check using S_ISREG(): see comment in file_traverser.cpp
-        return { ItemType::FILE, statData.st_mtime, makeUnsigned(statData.st_size), generateFileId(statData) };
+    return makeItemDetails(statData);
 }
 
-ItemDetailsRaw getSymlinkTargetDetails(const Zstring& linkPath) //throw FileError
+
+ItemDetailsRaw getSymlinkTargetDetails(const Zstring& linkPath, int statxFlags) //throw FileError
 {
+    try
+    {
+        if (std::optional<ItemDetailsRaw> details = tryGetItemDetailsStatx(AT_FDCWD, linkPath.c_str(), statxFlags)) //throw SysError
+            return *details;
+    }
+    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot resolve symbolic link %x."), L"%x", fmtPath(linkPath)), e.toString()); }
+
     struct ::stat statData = {};
     if (::stat(linkPath.c_str(), &statData) != 0)
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot resolve symbolic link %x."), L"%x", fmtPath(linkPath)), L"stat");
 
-    if (S_ISDIR(statData.st_mode)) //a directory
-        return { ItemType::FOLDER, statData.st_mtime, 0, generateFileId(statData) };
-    else //a file or named pipe, etc.
-        return { ItemType::FILE, statData.st_mtime, makeUnsigned(statData.st_size), generateFileId(statData) };
+    return makeItemDetails(statData);
+}
+
+
+ItemDetailsRaw getFileDetails(FileBase::FileHandle fh, const Zstring& filePath) //throw FileError
+{
+    try
+    {
+        //open() already revalidated the attributes (NFS close-to-open consistency) => no need to sync again
+        if (std::optional<ItemDetailsRaw> details = tryGetItemDetailsStatx(fh, "", AT_EMPTY_PATH | AT_STATX_DONT_SYNC)) //throw SysError
+            return *details;
+    }
+    catch (const SysError& e) { throw FileError(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(filePath)), e.toString()); }
+
+    struct ::stat statData = {};
+    if (::fstat(fh, &statData) != 0)
+        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(filePath)), L"fstat");
+
+    return makeItemDetails(statData);
 }
 
 
 struct GetDirDetails
 {
-    GetDirDetails(const Zstring& dirPath) : dirPath_(dirPath) {}
+    GetDirDetails(const Zstring& dirPath, int statxFlags) : dirPath_(dirPath), statxFlags_(statxFlags) {}
 
-    using Result = std::vector<FsItemRaw>;
+    using Result = std::shared_ptr<const DirContentRaw>; //shared with GetItemDetailsBatch tasks
     Result operator()() const
     {
-        return getDirContentFlat(dirPath_); //throw FileError
+        return std::make_shared<const DirContentRaw>(getDirContentFlat(dirPath_, statxFlags_)); //throw FileError
     }
 
 private:
     Zstring dirPath_;
+    int statxFlags_;
 };
 
 
@@ -194,7 +368,7 @@ struct GetItemDetails //details not already retrieved by raw folder traversal
     };
     Result operator()() const
     {
-        return { rawItem_, getItemDetails(rawItem_.itemPath) }; //throw FileError
+        return { rawItem_, getItemDetails(rawItem_.itemPath, rawItem_.statxFlags) }; //throw FileError
     }
 
 private:
@@ -202,6 +376,78 @@ private:
 };
 
 
+/*  one scheduler task per item costs more than the lstat() itself: task allocation, two mutex locks, result round-trip to controlling thread
+    => get details for consecutive items of the same directory in one task
+    => submit all statx() of a batch at once via io_uring: parallelOps threads keep up to parallelOps * ITEM_DETAILS_BATCH_SIZE requests in flight
+    => single-item GetItemDetails is still used for error reporting + retry                                                               */
+const size_t ITEM_DETAILS_BATCH_SIZE = 64;
+
+struct GetItemDetailsBatch
+{
+    GetItemDetailsBatch(const std::shared_ptr<const DirContentRaw>& dirContent, size_t itemFirst, size_t itemLast) :
+        dirContent_(dirContent), itemFirst_(itemFirst), itemLast_(itemLast) {}
+
+    struct ItemResult
+    {
+        FsItemRaw raw;
+        std::optional<ItemDetailsRaw> details; //empty on error => retry via GetItemDetails to report
+    };
+    using Result = std::vector<ItemResult>;
+
+    Result operator()() const
+    {
+        const Zstring& dirPathPf = appendSeparator(dirContent_->dirPath);
+
+        Result output;
+        output.reserve(itemLast_ - itemFirst_);
+
+        std::for_each(dirContent_->items.begin() + itemFirst_,
+                      dirContent_->items.begin() + itemLast_, [&](const DirContentRaw::Item& item)
+        {
+            const Zstring itemName = dirContent_->getItemName(item);
+            output.push_back({ { itemName, dirPathPf + itemName, dirContent_->statxFlags }, std::nullopt });
+        });
+
+        std::vector<bool> haveStatx(output.size()); //statx() was run => no need to retry via getItemDetails()
+
+        if (statxAvailable)
+        {
+            std::vector<StatxRequest> requests(output.size());
+            for (size_t i = 0; i < output.size(); ++i)
+            {
+                requests[i].path  = output[i].raw.itemPath.c_str();
+                requests[i].flags = AT_SYMLINK_NOFOLLOW | dirContent_->statxFlags;
+                requests[i].mask  = STATX_MASK_FFS;
+            }
+
+            if (statxBatch(requests)) //noexcept
+                for (size_t i = 0; i < output.size(); ++i)
+                    if (requests[i].errorCode == 0)
+                    {
+                        output[i].details = makeItemDetails(requests[i].result);
+                        haveStatx[i] = static_cast<bool>(output[i].details);
+                    }
+                    else
+                        haveStatx[i] = true; //error => report via GetItemDetails
+            else
+                statxAvailable = false;
+        }
+
+        for (size_t i = 0; i < output.size(); ++i)
+            if (!haveStatx[i]) //fall back to lstat()
+                try { output[i].details = getItemDetails(output[i].raw.itemPath, output[i].raw.statxFlags); /*throw FileError*/ }
+                catch (FileError&) {}
+
+        return output;
+    }
+
+private:
+    std::shared_ptr<const DirContentRaw> dirContent_;
+    size_t itemFirst_;
+    size_t itemLast_;
+};
+
+
 struct GetLinkTargetDetails
 {
     GetLinkTargetDetails(const FsItemRaw& rawItem, const ItemDetailsRaw& linkDetails) : rawItem_(rawItem), linkDetails_(linkDetails) {}
@@ -214,7 +460,7 @@ struct GetLinkTargetDetails
     };
     Result operator()() const
     {
-        return { rawItem_, linkDetails_, getSymlinkTargetDetails(rawItem_.itemPath) }; //throw FileError
+        return { rawItem_, linkDetails_, getSymlinkTargetDetails(rawItem_.itemPath, rawItem_.statxFlags) }; //throw FileError
     }
 
 private:
@@ -228,32 +474,61 @@ void traverseFolderRecursiveNative(const std::vector<std::pair<Zstring, std::sha
     std::vector<Task<TravContext, GetDirDetails>> genItems;
 
     for (const auto& [folderPath, cb] : initialTasks)
-        genItems.push_back({ GetDirDetails(folderPath),
+        genItems.push_back({ GetDirDetails(folderPath, getDeviceStatxFlags(folderPath)),
                              TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, cb /*TraverserCallback*/ }});
 
-    GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>(std::move(genItems), parallelOps, "Native Traverser"); //throw X
+    GenericDirTraverser<GetDirDetails, GetItemDetailsBatch, GetItemDetails, GetLinkTargetDetails>(std::move(genItems), parallelOps, "Native Traverser"); //throw X
 }
 }
 
 
 template <>
 template <>
-void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetDirDetails>(const GetDirDetails::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb /*throw X*/)
+void GenericDirTraverser<GetDirDetails, GetItemDetailsBatch, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetDirDetails>(const GetDirDetails::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb /*throw X*/)
 {
     //attention: if we simply appended to the work queue this would repeatedly allow for situations where a large number of directories are traversed one after another
     //           without intermittent calls to evalResultValue<GetItemDetails>() => user incorrectly thinks the app is hanging! https://freefilesync.org/forum/viewtopic.php?t=5729
-    //solution: *prepend* GetItemDetails() tasks (in correct order) to the work queue ASAP:
-    std::for_each(r.rbegin(), r.rend(), [&](const FsItemRaw& rawItem)
+    //solution: *prepend* GetItemDetailsBatch() tasks (in correct order) to the work queue ASAP:
+    const DirContentRaw& dirContent = *r;
+
+    std::vector<size_t> statItems; //indexes of items needing lstat()
+    statItems.reserve(dirContent.items.size());
+
+    for (size_t i = 0; i < dirContent.items.size(); ++i)
+        if (const DirContentRaw::Item& item = dirContent.items[i];
+            item.dirType == DT_DIR) //=> not a symlink: folder details not needed => skip lstat()
+        {
+            const Zstring itemName = dirContent.getItemName(item);
+
+            if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb->onFolder({ itemName, nullptr /*symlinkInfo*/ })) //throw X
+                scheduler_.run<GetDirDetails>({ GetDirDetails(appendSeparator(dirContent.dirPath) + itemName, dirContent.statxFlags), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
+        }
+        else //DT_LNK: need link modification time; DT_UNKNOWN: need item type
+            statItems.push_back(i);
+
+    //items needing lstat() are not necessarily consecutive => split into batches of consecutive ranges (the common case: none or all are folders)
+    std::vector<std::pair<size_t, size_t>> batches;
+    for (auto it = statItems.begin(); it != statItems.end();)
+    {
+        auto itLast = it + 1;
+        while (itLast != statItems.end() && *itLast == *(itLast - 1) + 1 && static_cast<size_t>(itLast - it) < ITEM_DETAILS_BATCH_SIZE)
+            ++itLast;
+
+        batches.emplace_back(*it, *(itLast - 1) + 1);
+        it = itLast;
+    }
+
+    std::for_each(batches.rbegin(), batches.rend(), [&](const std::pair<size_t, size_t>& batch)
     {
-        scheduler_.run<GetItemDetails>({ GetItemDetails(rawItem), TravContext{ rawItem.itemName, 0 /*errorRetryCount*/, cb }},
-                                       true /*insertFront*/);
+        scheduler_.run<GetItemDetailsBatch>({ GetItemDetailsBatch(r, batch.first, batch.second), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, cb }},
+                                            true /*insertFront*/);
     });
 }
 
 
 template <>
 template <>
-void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetItemDetails>(const GetItemDetails::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb /*throw X*/)
+void GenericDirTraverser<GetDirDetails, GetItemDetailsBatch, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetItemDetails>(const GetItemDetails::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb /*throw X*/)
 {
     switch (r.details.type)
     {
@@ -263,7 +538,7 @@ void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::e
 
         case ItemType::FOLDER:
             if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb->onFolder({ r.raw.itemName, nullptr /*symlinkInfo*/ })) //throw X
-                scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw.itemPath), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
+                scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw.itemPath, r.raw.statxFlags), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
             break;
 
         case ItemType::SYMLINK:
@@ -283,7 +558,20 @@ void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::e
 
 template <>
 template <>
-void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetLinkTargetDetails>(const GetLinkTargetDetails::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb /*throw X*/)
+void GenericDirTraverser<GetDirDetails, GetItemDetailsBatch, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetItemDetailsBatch>(const GetItemDetailsBatch::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb /*throw X*/)
+{
+    for (const GetItemDetailsBatch::ItemResult& itemResult : r)
+        if (itemResult.details)
+            evalResultValue<GetItemDetails>({ itemResult.raw, *itemResult.details }, cb); //throw X
+        else //redo single item to report error + support retry: item-level errors are rare => don't need to be fast
+            scheduler_.run<GetItemDetails>({ GetItemDetails(itemResult.raw), TravContext{ itemResult.raw.itemName, 0 /*errorRetryCount*/, cb }},
+                                           true /*insertFront*/);
+}
+
+
+template <>
+template <>
+void GenericDirTraverser<GetDirDetails, GetItemDetailsBatch, GetItemDetails, GetLinkTargetDetails>::evalResultValue<GetLinkTargetDetails>(const GetLinkTargetDetails::Result& r, std::shared_ptr<AFS::TraverserCallback>& cb /*throw X*/)
 {
     assert(r.link.type == ItemType::SYMLINK && r.target.type != ItemType::SYMLINK);
 
@@ -292,7 +580,7 @@ void GenericDirTraverser<GetDirDetails, GetItemDetails, GetLinkTargetDetails>::e
     if (r.target.type == ItemType::FOLDER)
     {
         if (std::shared_ptr<AFS::TraverserCallback> cbSub = cb->onFolder({ r.raw.itemName, &linkInfo })) //throw X
-            scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw.itemPath), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
+            scheduler_.run<GetDirDetails>({ GetDirDetails(r.raw.itemPath, r.raw.statxFlags), TravContext{ Zstring() /*errorItemName*/, 0 /*errorRetryCount*/, std::move(cbSub) }});
     }
     else //a file or named pipe, etc.
         cb->onFile({ r.raw.itemName, r.target.fileSize, r.target.modTime, convertToAbstractFileId(r.target.fileId), &linkInfo }); //throw X
@@ -319,22 +607,9 @@ private:
 
 //===========================================================================================================================
 
-    typedef struct ::stat FileAttribs; //GCC 5.2 fails when "::" is used in "using FileAttribs = struct ::stat"
-
-
-inline
-FileAttribs getFileAttributes(FileBase::FileHandle fh, const Zstring& filePath) //throw FileError
-{
-    struct ::stat fileAttr = {};
-    if (::fstat(fh, &fileAttr) != 0)
-        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file attributes of %x."), L"%x", fmtPath(filePath)), L"fstat");
-    return fileAttr;
-}
-
-
 struct InputStreamNative : public AbstractFileSystem::InputStream
 {
-    InputStreamNative(const Zstring& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/) : fi_(filePath, notifyUnbufferedIO) {} //throw FileError, ErrorFileLocked
+    InputStreamNative(const Zstring& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/) : fi_(filePath, getStreamingProfile(), notifyUnbufferedIO) {} //throw FileError, ErrorFileLocked
 
     size_t read(void* buffer, size_t bytesToRead) override { return fi_.read(buffer, bytesToRead); } //throw FileError, ErrorFileLocked, X; return "bytesToRead" bytes unless end of stream!
     size_t getBlockSize() const override { return fi_.getBlockSize(); } //non-zero block size is AFS contract!
@@ -347,15 +622,9 @@ private:
 
 std::optional<AFS::StreamAttributes> InputStreamNative::getAttributesBuffered() //throw FileError
 {
-    const FileAttribs fileAttr = getFileAttributes(fi_.getHandle(), fi_.getFilePath()); //throw FileError
+    const ItemDetailsRaw details = getFileDetails(fi_.getHandle(), fi_.getFilePath()); //throw FileError
 
-    const time_t modTime = fileAttr.st_mtime;
-
-    const uint64_t fileSize = makeUnsigned(fileAttr.st_size);
-
-    const AFS::FileId fileId = convertToAbstractFileId(generateFileId(fileAttr));
-
-    return AFS::StreamAttributes({ modTime, fileSize, fileId });
+    return AFS::StreamAttributes({ details.modTime, details.fileSize, convertToAbstractFileId(details.fileId) });
 }
 
 //===========================================================================================================================
@@ -366,7 +635,7 @@ struct OutputStreamNative : public AbstractFileSystem::OutputStreamImpl
                        std::optional<uint64_t> streamSize,
                        std::optional<time_t> modTime,
                        const IOCallback& notifyUnbufferedIO /*throw X*/) :
-        fo_(FileOutput::ACC_CREATE_NEW, filePath, notifyUnbufferedIO), //throw FileError, ErrorTargetExisting
+        fo_(FileOutput::ACC_CREATE_NEW, filePath, getStreamingProfile(), notifyUnbufferedIO), //throw FileError, ErrorTargetExisting
         modTime_(modTime)
     {
         if (streamSize) //pre-allocate file space, because we can
@@ -378,7 +647,7 @@ struct OutputStreamNative : public AbstractFileSystem::OutputStreamImpl
     AFS::FinalizeResult finalize() override //throw FileError, X
     {
         AFS::FinalizeResult result;
-        result.fileId = convertToAbstractFileId(generateFileId(getFileAttributes(fo_.getHandle(), fo_.getFilePath()))); //throw FileError
+        result.fileId = convertToAbstractFileId(getFileDetails(fo_.getHandle(), fo_.getFilePath()).fileId); //throw FileError
 
         fo_.finalize(); //throw FileError, X
 
@@ -504,6 +773,22 @@ private:
         return std::make_unique<InputStreamNative>(getNativePath(afsPath), notifyUnbufferedIO); //throw FileError, ErrorFileLocked
     }
 
+    std::optional<std::vector<std::byte>> readFileBlocks(const AfsPath& afsPath, const std::vector<uint64_t>& offsets, size_t blockSize, //throw FileError, ErrorFileLocked, X
+                                                         const IOCallback& notifyUnbufferedIO /*throw X*/) const override
+    {
+        initComForThread(); //throw FileError
+        FileInput fileIn(getNativePath(afsPath), notifyUnbufferedIO); //throw FileError, ErrorFileLocked
+        ::posix_fadvise(fileIn.getHandle(), 0, 0, POSIX_FADV_RANDOM); //best effort: don't read ahead beyond the blocks
+
+        std::vector<std::byte> buffer(offsets.size() * blockSize);
+        size_t bytesTotal = 0;
+        for (uint64_t offset : offsets)
+            bytesTotal += fileIn.readAt(offset, &buffer[bytesTotal], blockSize); //throw FileError, X
+
+        buffer.resize(bytesTotal);
+        return buffer;
+    }
+
     //target existing: undefined behavior! (fail/overwrite/auto-rename) => Native will fail and give a clear error message
     std::unique_ptr<OutputStreamImpl> getOutputStream(const AfsPath& afsPath, //throw FileError
                                                       std::optional<uint64_t> streamSize,
@@ -530,14 +815,14 @@ private:
     //symlink handling: follow link!
     //target existing: undefined behavior! (fail/overwrite/auto-rename) => Native will fail and give a clear error message
     FileCopyResult copyFileForSameAfsType(const AfsPath& afsPathSource, const StreamAttributes& attrSource, //throw FileError, ErrorFileLocked, X
-                                          const AbstractPath& apTarget, bool copyFilePermissions, const IOCallback& notifyUnbufferedIO /*throw X*/) const override
+                                          const AbstractPath& apTarget, bool copyFilePermissions, size_t stripeCount, const IOCallback& notifyUnbufferedIO /*throw X*/) const override
     {
         const Zstring nativePathTarget = static_cast<const NativeFileSystem&>(apTarget.afsDevice.ref()).getNativePath(apTarget.afsPath);
 
         initComForThread(); //throw FileError
 
         const zen::FileCopyResult nativeResult = copyNewFile(getNativePath(afsPathSource), nativePathTarget, //throw FileError, ErrorTargetExisting, ErrorFileLocked, X
-                                                             copyFilePermissions, notifyUnbufferedIO);
+                                                             copyFilePermissions, stripeCount, getStreamingProfile(), notifyUnbufferedIO);
         FileCopyResult result;
         result.fileSize     = nativeResult.fileSize;
         result.modTime      = nativeResult.modTime;
@@ -683,6 +968,16 @@ void RecycleSessionNative::tryCleanup(const std::function<void (const std::wstri
 }
 
 
+void fff::setNativeStreamingProfile(const IOProfile& profile)
+{
+    IOProfile profileFmt = profile;
+    profileFmt.blockSize = std::clamp<size_t>(profileFmt.blockSize, DIRECT_IO_ALIGNMENT, 64 * 1024 * 1024);
+    profileFmt.blockSize = (profileFmt.blockSize + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT; //O_DIRECT
+
+    globalStreamingProfile.set(std::make_unique<const IOProfile>(profileFmt));
+}
+
+
 //coordinate changes with getResolvedFilePath()!
 bool fff::acceptsItemPathPhraseNative(const Zstring& itemPathPhrase) //noexcept
 {
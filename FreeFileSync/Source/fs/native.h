@@ -7,6 +7,7 @@
 #ifndef FS_NATIVE_183247018532434563465
 #define FS_NATIVE_183247018532434563465
 
+#include <zen/file_io.h>
 #include "abstract.h"
 
 namespace fff
@@ -16,6 +17,9 @@ AbstractPath createItemPathNative(const Zstring& itemPathPhrase); //noexcept
 
 AbstractPath createItemPathNativeNoFormatting(const Zstring& nativePath); //noexcept
 
+//applies to file content streamed from/to native folders, e.g. file copy, verification
+void setNativeStreamingProfile(const zen::IOProfile& profile);
+
 inline
 AbstractPath getNullPath() { return createItemPathNativeNoFormatting(Zstring()); }
 }
@@ -3697,6 +3697,7 @@ void MainDialog::OnCompare(wxCommandEvent& event)
         //COMPARE DIRECTORIES
         folderCmp_ = compare(globalCfg_.warnDlgs,
                              globalCfg_.fileTimeTolerance,
+                             globalCfg_.cacheContentHashes,
                              true, //allowUserInteraction
                              globalCfg_.runWithBackgroundPriority,
                              globalCfg_.createLockFile,
@@ -3940,10 +3941,13 @@ void MainDialog::OnStartSync(wxCommandEvent& event)
                         globalCfg_.copyLockedFiles,
                         globalCfg_.copyFilePermissions,
                         globalCfg_.failSafeFileCopy,
+                        globalCfg_.stripedCopyMinSizeMB,
+                        globalCfg_.streamingIO,
                         globalCfg_.runWithBackgroundPriority,
                         extractSyncCfg(guiCfg.mainCfg),
                         folderCmp_,
                         deviceParallelOps,
+                        guiCfg.mainCfg.deviceParallelWrites,
                         globalCfg_.warnDlgs,
                         statusHandler); //throw AbortProcess
         }
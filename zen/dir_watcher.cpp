@@ -24,31 +24,86 @@ using namespace zen;
 
 struct DirWatcher::Impl
 {
+    void addWatches(const Zstring& folderPath, bool newFolder); //throw FileError
+    void removeWatches(const Zstring& folderPath);
+    void renameWatches(const Zstring& folderPathOld, const Zstring& folderPathNew);
+
     int notifDescr = 0;
     std::map<int, Zstring> watchedPaths; //watch descriptor and (sub-)directory paths -> owned by "notifDescr"
 };
 
 
-DirWatcher::DirWatcher(const Zstring& dirPath) : //throw FileError
-    baseDirPath_(dirPath),
-    pimpl_(std::make_unique<Impl>())
+//watch folder and all its subfolders
+//newFolder: created after watching started => might be gone already: no error, deletion is reported by parent watch
+void DirWatcher::Impl::addWatches(const Zstring& folderPath, bool newFolder) //throw FileError
 {
-    //get all subdirectories
-    std::vector<Zstring> fullFolderList { baseDirPath_ };
+    const int wd = ::inotify_add_watch(notifDescr, folderPath.c_str(),
+                                       IN_ONLYDIR     | //"Only watch pathname if it is a directory."
+                                       IN_DONT_FOLLOW | //don't follow symbolic links
+                                       IN_CREATE      |
+                                       IN_MODIFY      |
+                                       IN_CLOSE_WRITE |
+                                       IN_DELETE      |
+                                       IN_DELETE_SELF |
+                                       IN_MOVED_FROM  |
+                                       IN_MOVED_TO    |
+                                       IN_MOVE_SELF);
+    if (wd == -1)
     {
-        std::function<void (const Zstring& path)> traverse;
+        const ErrorCode ec = getLastError(); //copy before directly/indirectly making other system calls!
+        if (newFolder && (ec == ENOENT || ec == ENOTDIR))
+            return;
 
-        traverse = [&traverse, &fullFolderList](const Zstring& path)
-        {
-            traverseFolder(path, nullptr,
-            [&](const FolderInfo& fi ) { fullFolderList.push_back(fi.fullPath); traverse(fi.fullPath); },
-            nullptr, //don't traverse into symlinks (analog to windows build)
-            [&](const std::wstring& errorMsg) { throw FileError(errorMsg); });
-        };
+        if (ec == ENOSPC) //fix misleading system message "No space left on device"
+            throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(folderPath)),
+                            formatSystemError(L"inotify_add_watch", numberTo<std::wstring>(ec), L"The user limit on the total number of inotify watches was reached or the kernel failed to allocate a needed resource."));
 
-        traverse(baseDirPath_);
+        throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(folderPath)), formatSystemError(L"inotify_add_watch", ec));
     }
+    watchedPaths.insert_or_assign(wd, folderPath); //same wd if folder is already watched, e.g. move notification split between two getChanges()
+
+    //traverse *after* adding the watch: don't miss subfolders created in the meantime
+    std::vector<Zstring> subFolderPaths;
+    traverseFolder(folderPath, nullptr,
+    [&](const FolderInfo& fi) { subFolderPaths.push_back(fi.fullPath); },
+    nullptr, //don't traverse into symlinks (analog to windows build)
+    [&](const std::wstring& errorMsg) { if (!newFolder) throw FileError(errorMsg); });
+
+    for (const Zstring& subFolderPath : subFolderPaths)
+        addWatches(subFolderPath, newFolder); //throw FileError
+}
+
+
+void DirWatcher::Impl::removeWatches(const Zstring& folderPath)
+{
+    const Zstring folderPathPf = appendSeparator(folderPath);
+
+    for (auto it = watchedPaths.begin(); it != watchedPaths.end();)
+        if (it->second == folderPath || startsWith(it->second, folderPathPf))
+        {
+            ::inotify_rm_watch(notifDescr, it->first); //"IN_IGNORED" notification will find nothing to erase
+            it = watchedPaths.erase(it);
+        }
+        else
+            ++it;
+}
+
+
+void DirWatcher::Impl::renameWatches(const Zstring& folderPathOld, const Zstring& folderPathNew)
+{
+    const Zstring folderPathOldPf = appendSeparator(folderPathOld);
+
+    //linear search: folder moves are rare, compared to file changes
+    for (auto& [wd, watchedPath] : watchedPaths)
+        if (watchedPath == folderPathOld || startsWith(watchedPath, folderPathOldPf))
+            watchedPath = folderPathNew + Zstring(watchedPath.begin() + folderPathOld.size(), watchedPath.end());
+}
 
+
+DirWatcher::DirWatcher(const Zstring& dirPath) : //throw FileError
+    baseDirPath_(dirPath),
+    pimpl_(std::make_unique<Impl>())
+{
     //init
     pimpl_->notifDescr  = ::inotify_init();
     if (pimpl_->notifDescr == -1)
@@ -66,32 +121,7 @@ DirWatcher::DirWatcher(const Zstring& dirPath) : //throw FileError
     if (!initSuccess)
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath_)), L"fcntl");
 
-    //add watches
-    for (const Zstring& subDirPath : fullFolderList)
-    {
-        int wd = ::inotify_add_watch(pimpl_->notifDescr, subDirPath.c_str(),
-                                     IN_ONLYDIR     | //"Only watch pathname if it is a directory."
-                                     IN_DONT_FOLLOW | //don't follow symbolic links
-                                     IN_CREATE      |
-                                     IN_MODIFY      |
-                                     IN_CLOSE_WRITE |
-                                     IN_DELETE      |
-                                     IN_DELETE_SELF |
-                                     IN_MOVED_FROM  |
-                                     IN_MOVED_TO    |
-                                     IN_MOVE_SELF);
-        if (wd == -1)
-        {
-            const ErrorCode ec = getLastError(); //copy before directly/indirectly making other system calls!
-            if (ec == ENOSPC) //fix misleading system message "No space left on device"
-                throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(subDirPath)),
-                                formatSystemError(L"inotify_add_watch", numberTo<std::wstring>(ec), L"The user limit on the total number of inotify watches was reached or the kernel failed to allocate a needed resource."));
-
-            throw FileError(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(subDirPath)), formatSystemError(L"inotify_add_watch", ec));
-        }
-
-        pimpl_->watchedPaths.emplace(wd, subDirPath);
-    }
+    pimpl_->addWatches(baseDirPath_, false /*newFolder*/); //throw FileError
 }
 
 
@@ -101,7 +131,7 @@ DirWatcher::~DirWatcher()
 }
 
 
-std::vector<DirWatcher::Entry> DirWatcher::getChanges(const std::function<void()>& requestUiRefresh, std::chrono::milliseconds cbInterval) //throw FileError
+std::vector<DirWatcher::Entry> DirWatcher::getChanges(const std::function<void()>& requestUiRefresh, std::chrono::milliseconds cbInterval) //throw FileError, ErrorWatchOverflow
 {
     std::vector<std::byte> buffer(512 * (sizeof(struct ::inotify_event) + NAME_MAX + 1));
 
@@ -122,13 +152,20 @@ std::vector<DirWatcher::Entry> DirWatcher::getChanges(const std::function<void()
     }
 
     std::vector<Entry> output;
+    std::map<uint32_t, Zstring> movedFromFolders; //cookie => folder path; moved within watched tree or out of it?
 
     ssize_t bytePos = 0;
     while (bytePos < bytesRead)
     {
         struct ::inotify_event& evt = reinterpret_cast<struct ::inotify_event&>(buffer[bytePos]);
 
-        if (evt.len != 0) //exclude case: deletion of "self", already reported by parent directory watch
+        if (evt.mask & IN_Q_OVERFLOW) //notifications were lost, including IN_CREATE for new subfolders => watches are incomplete
+            throw ErrorWatchOverflow(replaceCpy(_("Cannot monitor directory %x."), L"%x", fmtPath(baseDirPath_)), L"Event queue overflow (IN_Q_OVERFLOW).");
+
+        else if (evt.mask & IN_IGNORED) //watch was removed: folder deleted or file system unmounted
+            pimpl_->watchedPaths.erase(evt.wd);
+
+        else if (evt.len != 0) //exclude case: deletion of "self", already reported by parent directory watch
         {
             auto it = pimpl_->watchedPaths.find(evt.wd);
             if (it != pimpl_->watchedPaths.end())
@@ -139,7 +176,20 @@ std::vector<DirWatcher::Entry> DirWatcher::getChanges(const std::function<void()
 
                 if ((evt.mask & IN_CREATE) ||
                     (evt.mask & IN_MOVED_TO))
+                {
+                    if (evt.mask & IN_ISDIR)
+                    {
+                        auto itFrom = (evt.mask & IN_MOVED_TO) ? movedFromFolders.find(evt.cookie) : movedFromFolders.end();
+                        if (itFrom != movedFromFolders.end()) //moved within watched tree: watches are kept by inotify
+                        {
+                            pimpl_->renameWatches(itFrom->second, itemPath);
+                            movedFromFolders.erase(itFrom);
+                        }
+                        else
+                            pimpl_->addWatches(itemPath, true /*newFolder*/); //throw FileError
+                    }
                     output.push_back({ ACTION_CREATE, itemPath });
+                }
                 else if ((evt.mask & IN_MODIFY) ||
                          (evt.mask & IN_CLOSE_WRITE))
                     output.push_back({ ACTION_UPDATE, itemPath });
@@ -147,12 +197,20 @@ std::vector<DirWatcher::Entry> DirWatcher::getChanges(const std::function<void()
                          (evt.mask & IN_DELETE_SELF) ||
                          (evt.mask & IN_MOVE_SELF  ) ||
                          (evt.mask & IN_MOVED_FROM))
+                {
+                    if ((evt.mask & IN_MOVED_FROM) && (evt.mask & IN_ISDIR))
+                        movedFromFolders.emplace(evt.cookie, itemPath);
                     output.push_back({ ACTION_DELETE, itemPath });
+                }
             }
         }
         bytePos += sizeof(struct ::inotify_event) + evt.len;
     }
 
+    //moved out of watched tree (or IN_MOVED_TO is part of the next read()): inotify watches follow the folder => remove
+    for (const auto& [cookie, folderPath] : movedFromFolders)
+        pimpl_->removeWatches(folderPath);
+
     return output;
 }
 
@@ -29,13 +29,15 @@ namespace zen
              Renaming of top watched directory handled incorrectly: Not notified(!) + additional changes in subfolders
              now do report FILE_ACTION_MODIFIED for directory (check that should prevent this fails!)
 
-    Linux: newly added subdirectories are reported but not automatically added for watching! -> reset Dirwatcher!
+    Linux: newly added subdirectories are reported but not automatically added for watching! -> DirWatcher adds them when processing changes
            removal of top watched directory is NOT notified!
 
     OS X: everything works as expected; renaming of top level folder is also detected
 
-    Overcome all issues portably: check existence of top watched directory externally + reinstall watch after changes in directory structure (added directories) are detected
+    Overcome all issues portably: check existence of top watched directory externally
 */
+DEFINE_NEW_FILE_ERROR(ErrorWatchOverflow); //notifications were lost => watched folders may be out of sync: recreate DirWatcher
+
 class DirWatcher
 {
 public:
@@ -55,8 +57,8 @@ public:
         Zstring itemPath;
     };
 
-    //extract accumulated changes since last call
-    std::vector<Entry> getChanges(const std::function<void()>& requestUiRefresh, std::chrono::milliseconds cbInterval); //throw FileError
+    //extract accumulated changes since last call: long-lived, keeps watching folders created/moved/deleted in the meantime
+    std::vector<Entry> getChanges(const std::function<void()>& requestUiRefresh, std::chrono::milliseconds cbInterval); //throw FileError, ErrorWatchOverflow
 
 private:
     DirWatcher           (const DirWatcher&) = delete;
@@ -16,6 +16,7 @@
 #include "file_io.h"
 #include "crc.h"
 #include "guid.h"
+#include "thread.h"
 
     #include <sys/vfs.h> //statfs
     #include <sys/time.h> //lutimes
@@ -26,6 +27,9 @@
 
     #include <fcntl.h> //open, close, AT_SYMLINK_NOFOLLOW, UTIME_OMIT
     #include <sys/stat.h>
+    #include <sys/ioctl.h>
+    #include <sys/sendfile.h>
+    #include <linux/fs.h> //FICLONE
 
 using namespace zen;
 
@@ -612,13 +616,273 @@ void zen::copySymlink(const Zstring& sourceLink, const Zstring& targetLink, bool
 
 namespace
 {
+/*  copy without pushing the data through user space:
+      1. FICLONE (btrfs, XFS with reflink=1, OCFS2): share extents => no data is moved at all
+      2. copy_file_range(): server-side copy on NFS 4.2/CIFS, in-kernel copy otherwise (Linux 4.5+, cross-file-system only Linux 5.3 - 5.18)
+      3. sendfile(): in-kernel copy between any two file systems
+    => fall back to the next method if the current one is not supported for this pair of files                                         */
+const size_t KERNEL_COPY_BLOCK_SIZE = 8 * 1024 * 1024; //cancel/progress granularity: kernel copy blocks until the full block is done!
+
+
+inline
+bool isKernelCopyUnsupported(int ec) //error means "try next copy method", not "copy failed"
+{
+    return ec == EXDEV      || //different file systems
+           ec == EINVAL     || //unsupported file type or file system
+           ec == ENOSYS     || //kernel too old
+           ec == EOPNOTSUPP ||
+           ec == ENOTTY     || //FICLONE: ioctl not implemented
+           ec == EPERM;        //seccomp
+}
+
+
+//returns number of bytes cloned or none if cloning is not supported: file positions of both handles are set to the end
+std::optional<uint64_t> tryCloneFileKernel(int fdSource, const Zstring& sourceFile, //throw FileError, X
+                                           int fdTarget, const Zstring& targetFile, const IOCallback& notifyUnbufferedIO /*throw X*/)
+{
+    if (::ioctl(fdTarget, FICLONE, fdSource) == 0) //clones the full file *without* advancing file positions
+    {
+        if (::lseek(fdSource, 0, SEEK_END) == -1) //=> buffered copy of remaining bytes is a no-op
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(sourceFile)), L"lseek");
+        const off_t targetSize = ::lseek(fdTarget, 0, SEEK_END);
+        if (targetSize == -1)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(targetFile)), L"lseek");
+
+        if (notifyUnbufferedIO) notifyUnbufferedIO(targetSize); //throw X
+        return targetSize;
+    }
+    else if (!isKernelCopyUnsupported(errno))
+        THROW_LAST_FILE_ERROR(replaceCpy(replaceCpy(_("Cannot copy file %x to %y."), L"%x", L"\n" + fmtPath(sourceFile)), L"%y", L"\n" + fmtPath(targetFile)), L"ioctl(FICLONE)");
+    return {};
+}
+
+
+//returns number of bytes copied: file positions of both handles are advanced accordingly
+//caller must copy the rest (if any) using buffered I/O; e.g. kernel copy unsupported, or source file grew in the meantime
+uint64_t tryCopyFileKernel(int fdSource, const Zstring& sourceFile, //throw FileError, X
+                           int fdTarget, const Zstring& targetFile, uint64_t fileSize, bool dropPageCache, const IOCallback& notifyUnbufferedIO /*throw X*/)
+{
+    if (fileSize == 0) //nothing to gain; also: /proc, /sys files report size 0
+        return 0;
+
+    if (const std::optional<uint64_t> bytesCloned = tryCloneFileKernel(fdSource, sourceFile, fdTarget, targetFile, notifyUnbufferedIO)) //throw FileError, X
+        return *bytesCloned;
+
+    PageCacheEvictor targetEvictor(fdTarget);
+    ZEN_ON_SCOPE_EXIT(if (dropPageCache) targetEvictor.finish());
+
+    uint64_t bytesCopied = 0;
+
+    for (bool useSendFile : { false, true })
+        while (bytesCopied < fileSize)
+        {
+            const size_t bytesToCopy = static_cast<size_t>(std::min<uint64_t>(fileSize - bytesCopied, KERNEL_COPY_BLOCK_SIZE));
+
+            const ssize_t bytesWritten = useSendFile ?
+                                         ::sendfile(fdTarget, fdSource, nullptr, bytesToCopy) :
+                                         ::copy_file_range(fdSource, nullptr, fdTarget, nullptr, bytesToCopy, 0);
+            if (bytesWritten < 0)
+            {
+                if (errno == EINTR)
+                    continue;
+                if (isKernelCopyUnsupported(errno))
+                    break; //=> try next method
+                THROW_LAST_FILE_ERROR(replaceCpy(replaceCpy(_("Cannot copy file %x to %y."), L"%x", L"\n" + fmtPath(sourceFile)), L"%y", L"\n" + fmtPath(targetFile)),
+                                      useSendFile ? L"sendfile" : L"copy_file_range");
+            }
+            if (bytesWritten == 0) //source file shrunk in the meantime
+                return bytesCopied;
+
+            if (dropPageCache)
+            {
+                ::posix_fadvise(fdSource, bytesCopied, bytesWritten, POSIX_FADV_DONTNEED); //best effort
+                targetEvictor.onWritten(bytesCopied, bytesWritten);
+            }
+            bytesCopied += bytesWritten;
+            if (notifyUnbufferedIO) notifyUnbufferedIO(bytesWritten); //throw X
+        }
+
+    return bytesCopied;
+}
+
+
+/*  copy disjoint byte ranges on parallel threads: a single sequential stream never keeps more than one request in flight
+    => worth it for large files on devices with deep I/O queues (NVMe RAID, NFS over fast links)
+    - IOCallback is not thread-safe: workers only count the bytes, calling thread reports them
+    - target is preallocated: stripes are written out of order; fail early on insufficient disk space  */
+const uint64_t STRIPE_SIZE_MIN = 8 * KERNEL_COPY_BLOCK_SIZE; //don't bother starting threads for a few blocks each
+
+
+//returns number of bytes copied: file positions of both handles are set accordingly
+//caller must copy the rest (if any) using buffered I/O; e.g. source file grew in the meantime
+uint64_t copyFileStriped(int fdSource, const Zstring& sourceFile, //throw FileError, X
+                         int fdTarget, const Zstring& targetFile, uint64_t fileSize, size_t stripeCount, const IOProfile& ioProfile, const IOCallback& notifyUnbufferedIO /*throw X*/)
+{
+    if (const std::optional<uint64_t> bytesCloned = tryCloneFileKernel(fdSource, sourceFile, fdTarget, targetFile, notifyUnbufferedIO)) //throw FileError, X
+        return *bytesCloned;
+
+    if (::fallocate(fdTarget, 0 /*mode: extend file size*/, 0, fileSize) != 0)
+    {
+        if (errno != EOPNOTSUPP && errno != ENOSYS) //e.g. NFS < 4.2: sparse target is fine, too
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(targetFile)), L"fallocate");
+
+        if (::ftruncate(fdTarget, fileSize) != 0)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(targetFile)), L"ftruncate");
+    }
+
+    std::atomic<int64_t> bytesPending{ 0 }; //std:atomic is uninitialized by default!
+    std::mutex lockResult;
+    uint64_t sourceEnd = fileSize; //less if source file shrunk in the meantime
+    std::exception_ptr error;
+
+    //context of worker thread
+    auto copyStripe = [&](uint64_t offsetBegin, uint64_t offsetEnd) //throw ThreadInterruption
+    {
+        setCurrentThreadName("File Copy Stripe");
+        try
+        {
+            bool useKernelCopy = !ioProfile.directIO; //O_DIRECT: need our own aligned buffer
+            std::unique_ptr<std::byte[], void (*)(void*)> buf(nullptr, ::free); //only needed if kernel copy is unsupported
+            PageCacheEvictor targetEvictor(fdTarget);
+            ZEN_ON_SCOPE_EXIT(if (ioProfile.dropPageCache) targetEvictor.finish());
+
+            for (uint64_t offset = offsetBegin; offset < offsetEnd;)
+            {
+                const size_t bytesToCopy = static_cast<size_t>(std::min<uint64_t>(offsetEnd - offset, KERNEL_COPY_BLOCK_SIZE));
+                ssize_t bytesCopied = 0;
+
+                if (useKernelCopy)
+                {
+                    loff_t offsetIn  = offset;
+                    loff_t offsetOut = offset;
+                    bytesCopied = ::copy_file_range(fdSource, &offsetIn, fdTarget, &offsetOut, bytesToCopy, 0);
+                    if (bytesCopied < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        if (!isKernelCopyUnsupported(errno))
+                            THROW_LAST_FILE_ERROR(replaceCpy(replaceCpy(_("Cannot copy file %x to %y."), L"%x", L"\n" + fmtPath(sourceFile)), L"%y", L"\n" + fmtPath(targetFile)), L"copy_file_range");
+                        useKernelCopy = false;
+                        continue;
+                    }
+                }
+                else
+                {
+                    if (!buf)
+                    {
+                        void* p = nullptr;
+                        if (::posix_memalign(&p, DIRECT_IO_ALIGNMENT, KERNEL_COPY_BLOCK_SIZE) != 0)
+                            throw std::bad_alloc();
+                        buf.reset(static_cast<std::byte*>(p));
+                    }
+
+                    //O_DIRECT: read and write aligned length, even for the tail => truncated below
+                    auto alignLength = [&](size_t len) { return ioProfile.directIO ? (len + DIRECT_IO_ALIGNMENT - 1) / DIRECT_IO_ALIGNMENT * DIRECT_IO_ALIGNMENT : len; };
+
+                    bytesCopied = ::pread(fdSource, &buf[0], alignLength(bytesToCopy), offset);
+                    if (bytesCopied < 0)
+                    {
+                        if (errno == EINTR)
+                            continue;
+                        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(sourceFile)), L"pread");
+                    }
+                    bytesCopied = std::min<ssize_t>(bytesCopied, bytesToCopy); //source file grew in the meantime => caller copies the rest
+
+                    const ssize_t bytesToWrite = alignLength(bytesCopied);
+
+                    for (ssize_t bytesWritten = 0; bytesWritten < bytesToWrite;)
+                    {
+                        const ssize_t bytesDelta = ::pwrite(fdTarget, &buf[bytesWritten], bytesToWrite - bytesWritten, offset + bytesWritten);
+                        if (bytesDelta <= 0)
+                        {
+                            if (bytesDelta < 0 && errno == EINTR)
+                                continue;
+                            if (bytesDelta == 0) //comment in safe-read.c suggests to treat this as an error due to buggy drivers
+                                errno = ENOSPC;
+
+                            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(targetFile)), L"pwrite");
+                        }
+                        bytesWritten += bytesDelta;
+                    }
+                }
+
+                if (bytesCopied == 0) //source file shrunk in the meantime
+                {
+                    std::lock_guard dummy(lockResult);
+                    sourceEnd = std::min(sourceEnd, offset);
+                    return;
+                }
+
+                if (ioProfile.dropPageCache)
+                {
+                    ::posix_fadvise(fdSource, offset, bytesCopied, POSIX_FADV_DONTNEED); //best effort
+                    targetEvictor.onWritten(offset, bytesCopied);
+                }
+                offset += bytesCopied;
+                bytesPending += bytesCopied; //like kernel copy: bypass IOCallbackDivider
+                interruptionPoint(); //throw ThreadInterruption
+            }
+        }
+        catch (ThreadInterruption&) { throw; }
+        catch (...)
+        {
+            std::lock_guard dummy(lockResult);
+            if (!error)
+                error = std::current_exception();
+        }
+    };
+
+    std::vector<InterruptibleThread> workers;
+    ZEN_ON_SCOPE_EXIT(for (InterruptibleThread& wt : workers) if (wt.joinable()) wt.interrupt(); //interrupt all first, then join
+                      for (InterruptibleThread& wt : workers) if (wt.joinable()) wt.join(););
+
+    //stripe boundaries aligned to block size: no block straddles two stripes
+    stripeCount = static_cast<size_t>(std::max<uint64_t>(1, std::min<uint64_t>(stripeCount, fileSize / STRIPE_SIZE_MIN)));
+    const uint64_t stripeSize = (fileSize / stripeCount + KERNEL_COPY_BLOCK_SIZE - 1) / KERNEL_COPY_BLOCK_SIZE * KERNEL_COPY_BLOCK_SIZE;
+
+    for (uint64_t offset = 0; offset < fileSize; offset += stripeSize)
+        workers.emplace_back([&copyStripe, offset, offsetEnd = std::min(offset + stripeSize, fileSize)] { copyStripe(offset, offsetEnd); });
+
+    //context of calling thread
+    for (InterruptibleThread& wt : workers)
+        for (;;)
+        {
+            const bool stripeDone = wt.tryJoinFor(std::chrono::milliseconds(50));
+
+            if (const int64_t bytesDelta = bytesPending.exchange(0); bytesDelta != 0)
+                if (notifyUnbufferedIO) notifyUnbufferedIO(bytesDelta); //throw X
+            {
+                std::lock_guard dummy(lockResult);
+                if (error)
+                    std::rethrow_exception(error); //throw FileError
+            }
+            if (stripeDone)
+                break;
+        }
+
+    if (sourceEnd < fileSize || ioProfile.directIO)
+        if (::ftruncate(fdTarget, sourceEnd) != 0)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(targetFile)), L"ftruncate");
+
+    //stripes used explicit offsets => position both handles behind the copied data
+    if (::lseek(fdSource, sourceEnd, SEEK_SET) == -1)
+        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(sourceFile)), L"lseek");
+    if (::lseek(fdTarget, sourceEnd, SEEK_SET) == -1)
+        THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(targetFile)), L"lseek");
+
+    return sourceEnd;
+}
+
+
 FileCopyResult copyFileOsSpecific(const Zstring& sourceFile, //throw FileError, ErrorTargetExisting
                                   const Zstring& targetFile,
+                                  size_t stripeCount,
+                                  const IOProfile& ioProfile,
                                   const IOCallback& notifyUnbufferedIO)
 {
     int64_t totalUnbufferedIO = 0;
 
-    FileInput fileIn(sourceFile, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError, (ErrorFileLocked -> Windows-only)
+    FileInput fileIn(sourceFile, ioProfile, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //throw FileError, (ErrorFileLocked -> Windows-only)
 
     struct ::stat sourceInfo = {};
     if (::fstat(fileIn.getHandle(), &sourceInfo) != 0)
@@ -644,11 +908,25 @@ FileCopyResult copyFileOsSpecific(const Zstring& sourceFile, //throw FileError,
     catch (FileError&) {} );
     //place guard AFTER ::open() and BEFORE lifetime of FileOutput:
     //=> don't delete file that existed previously!!!
-    FileOutput fileOut(fdTarget, targetFile, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //pass ownership
+    FileOutput fileOut(fdTarget, targetFile, ioProfile, IOCallbackDivider(notifyUnbufferedIO, totalUnbufferedIO)); //pass ownership
 
     //fileOut.preAllocateSpaceBestEffort(sourceInfo.st_size); //throw FileError
     //=> perf: seems like no real benefit...
 
+    //kernel copy reports full bytes copied (= read + written) directly: bypass IOCallbackDivider
+    if (S_ISREG(sourceInfo.st_mode))
+    {
+        if (stripeCount > 1 && static_cast<uint64_t>(sourceInfo.st_size) >= 2 * STRIPE_SIZE_MIN)
+            copyFileStriped(fileIn.getHandle(), sourceFile, fileOut.getHandle(), targetFile, sourceInfo.st_size, stripeCount, ioProfile, notifyUnbufferedIO); //throw FileError, X
+        else if (ioProfile.directIO) //kernel copy would go through the page cache: clone or copy using our aligned buffers
+            tryCloneFileKernel(fileIn.getHandle(), sourceFile, fileOut.getHandle(), targetFile, notifyUnbufferedIO); //throw FileError, X
+        else
+            tryCopyFileKernel(fileIn.getHandle(), sourceFile, fileOut.getHandle(), targetFile, sourceInfo.st_size, ioProfile.dropPageCache, notifyUnbufferedIO); //throw FileError, X
+    }
+
+    //copy remaining bytes (if any) at the current file positions:
+    fileIn .syncStreamPosition(); //kernel copy may have moved file positions: keep page cache hints in sync
+    fileOut.syncStreamPosition(); //
     bufferedStreamCopy(fileIn, fileOut); //throw FileError, (ErrorFileLocked), X
 
     //flush intermediate buffers before fiddling with the raw file handle
@@ -700,9 +978,9 @@ copyFileWindowsDefault(::CopyFileEx)  copyFileWindowsStream(::BackupRead/::Backu
 
 
 FileCopyResult zen::copyNewFile(const Zstring& sourceFile, const Zstring& targetFile, bool copyFilePermissions, //throw FileError, ErrorTargetExisting, ErrorFileLocked, X
-                                const IOCallback& notifyUnbufferedIO /*throw X*/)
+                                size_t stripeCount, const IOProfile& ioProfile, const IOCallback& notifyUnbufferedIO /*throw X*/)
 {
-    const FileCopyResult result = copyFileOsSpecific(sourceFile, targetFile, notifyUnbufferedIO); //throw FileError, ErrorTargetExisting, ErrorFileLocked, X
+    const FileCopyResult result = copyFileOsSpecific(sourceFile, targetFile, stripeCount, ioProfile, notifyUnbufferedIO); //throw FileError, ErrorTargetExisting, ErrorFileLocked, X
 
     //at this point we know we created a new file, so it's fine to delete it for cleanup!
     ZEN_ON_SCOPE_FAIL(try { removeFilePlain(targetFile); }
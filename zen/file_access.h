@@ -91,6 +91,8 @@ void tryCopyDirectoryAttributes(const Zstring& sourcePath, const Zstring& target
 
 void copySymlink(const Zstring& sourceLink, const Zstring& targetLink, bool copyFilePermissions); //throw FileError
 
+struct IOProfile;
+
 struct FileCopyResult
 {
     uint64_t fileSize = 0;
@@ -101,6 +103,8 @@ struct FileCopyResult
 };
 
 FileCopyResult copyNewFile(const Zstring& sourceFile, const Zstring& targetFile, bool copyFilePermissions, //throw FileError, ErrorTargetExisting, ErrorFileLocked, X
+                           size_t stripeCount, //> 1: copy large files as disjoint byte ranges on parallel threads
+                           const IOProfile& ioProfile,
                            //accummulated delta != file size! consider ADS, sparse, compressed files
                            const IOCallback& notifyUnbufferedIO /*throw X*/); 
 }
@@ -16,6 +16,13 @@ using namespace zen;
 
 namespace
 {
+uint64_t getStreamPosition(FileBase::FileHandle fh) //for page cache hints only => best effort
+{
+    const off_t pos = ::lseek(fh, 0, SEEK_CUR);
+    return pos == -1 ? 0 : pos;
+}
+
+
 //- "filePath" could be a named pipe which *blocks* forever for open()!
 //- open() with O_NONBLOCK avoids the block, but opens successfully
 //- create sample pipe: "sudo mkfifo named_pipe"
@@ -48,6 +55,18 @@ void checkForUnsupportedType(const Zstring& filePath) //throw FileError
     const FileBase::FileHandle FileBase::invalidHandleValue = -1;
 
 
+FileBase::FileBase(FileHandle handle, const Zstring& filePath, const IOProfile& profile) :
+    fileHandle_(handle), filePath_(filePath), profile_(profile)
+{
+    assert(!profile_.directIO || profile_.blockSize % DIRECT_IO_ALIGNMENT == 0);
+
+    //set after open(): O_CREAT | O_DIRECT creates the file even if open() then fails with EINVAL (e.g. tmpfs)
+    if (profile_.directIO) //best effort
+        if (const int flags = ::fcntl(fileHandle_, F_GETFL); flags != -1)
+            ::fcntl(fileHandle_, F_SETFL, flags | O_DIRECT);
+}
+
+
 FileBase::~FileBase()
 {
     if (fileHandle_ != invalidHandleValue)
@@ -71,6 +90,56 @@ void FileBase::close() //throw FileError
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getFilePath())), L"close");
 }
 
+
+FileBase::BlockBuffer FileBase::allocateBlockBuffer() const
+{
+    void* buf = nullptr;
+    if (::posix_memalign(&buf, DIRECT_IO_ALIGNMENT, getBlockSize()) != 0)
+        throw std::bad_alloc();
+    return BlockBuffer(static_cast<std::byte*>(buf), ::free);
+}
+
+
+bool FileBase::disableDirectIO()
+{
+    if (!profile_.directIO)
+        return false;
+
+    const int flags = ::fcntl(fileHandle_, F_GETFL);
+    if (flags == -1 || !(flags & O_DIRECT))
+        return false;
+
+    return ::fcntl(fileHandle_, F_SETFL, flags & ~O_DIRECT) == 0;
+}
+
+
+void zen::evictPageCacheRange(FileBase::FileHandle fh, uint64_t offset, uint64_t length)
+{
+    if (length == 0) //sync_file_range(): "nbytes == 0" means "until end of file"
+        return;
+    //no error handling: page cache is only an optimization
+    ::sync_file_range(fh, offset, length, SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+    ::posix_fadvise(fh, offset, length, POSIX_FADV_DONTNEED);
+}
+
+
+void PageCacheEvictor::onWritten(uint64_t offset, uint64_t length)
+{
+    if (length == 0)
+        return;
+    ::sync_file_range(fh_, offset, length, SYNC_FILE_RANGE_WRITE); //best effort
+    evictPageCacheRange(fh_, pendingOffset_, pendingLength_);
+    pendingOffset_ = offset;
+    pendingLength_ = length;
+}
+
+
+void PageCacheEvictor::finish()
+{
+    evictPageCacheRange(fh_, pendingOffset_, pendingLength_);
+    pendingLength_ = 0;
+}
+
 //----------------------------------------------------------------------------------------------------
 
 namespace
@@ -79,7 +148,7 @@ FileBase::FileHandle openHandleForRead(const Zstring& filePath) //throw FileErro
 {
     checkForUnsupportedType(filePath); //throw FileError; opening a named pipe would block forever!
 
-    //don't use O_DIRECT: http://yarchive.net/comp/linux/o_direct.html
+    //don't use O_DIRECT by default: http://yarchive.net/comp/linux/o_direct.html => IOProfile::directIO
     const FileBase::FileHandle fileHandle = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
     if (fileHandle == -1) //don't check "< 0" -> docu seems to allow "-2" to be a valid file handle
         THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot open file %x."), L"%x", fmtPath(filePath)), L"open");
@@ -89,11 +158,22 @@ FileBase::FileHandle openHandleForRead(const Zstring& filePath) //throw FileErro
 
 
 FileInput::FileInput(FileHandle handle, const Zstring& filePath, const IOCallback& notifyUnbufferedIO) :
-    FileBase(handle, filePath), notifyUnbufferedIO_(notifyUnbufferedIO) {}
+    FileBase(handle, filePath, IOProfile()), notifyUnbufferedIO_(notifyUnbufferedIO), readPos_(getStreamPosition(handle)) {}
+
+
+void FileInput::syncStreamPosition()
+{
+    assert(bufPos_ == bufPosEnd_);
+    readPos_ = getStreamPosition(getHandle());
+}
 
 
 FileInput::FileInput(const Zstring& filePath, const IOCallback& notifyUnbufferedIO) :
-    FileBase(openHandleForRead(filePath), filePath), //throw FileError, ErrorFileLocked
+    FileInput(filePath, IOProfile(), notifyUnbufferedIO) {} //throw FileError, ErrorFileLocked
+
+
+FileInput::FileInput(const Zstring& filePath, const IOProfile& profile, const IOCallback& notifyUnbufferedIO) :
+    FileBase(openHandleForRead(filePath), filePath, profile), //throw FileError, ErrorFileLocked
     notifyUnbufferedIO_(notifyUnbufferedIO)
 {
     //optimize read-ahead on input file:
@@ -114,7 +194,8 @@ size_t FileInput::tryRead(void* buffer, size_t bytesToRead) //throw FileError, E
     {
         bytesRead = ::read(getHandle(), buffer, bytesToRead);
     }
-    while (bytesRead < 0 && errno == EINTR); //Compare copy_reg() in copy.c: ftp://ftp.gnu.org/gnu/coreutils/coreutils-8.23.tar.xz
+    while ((bytesRead < 0 && errno == EINTR) || //Compare copy_reg() in copy.c: ftp://ftp.gnu.org/gnu/coreutils/coreutils-8.23.tar.xz
+           (bytesRead < 0 && errno == EINVAL && disableDirectIO())); //O_DIRECT: file position no longer aligned after a short read
     //EINTR is not checked on macOS' copyfile: https://opensource.apple.com/source/copyfile/copyfile-146/copyfile.c.auto.html
     //read() on macOS: https://developer.apple.com/legacy/library/documentation/Darwin/Reference/ManPages/man2/read.2.html
 
@@ -125,6 +206,10 @@ size_t FileInput::tryRead(void* buffer, size_t bytesToRead) //throw FileError, E
 
     //if ::read is interrupted (EINTR) right in the middle, it will return successfully with "bytesRead < bytesToRead"
 
+    if (getProfile().dropPageCache && bytesRead > 0) //clean pages: no need to wait for writeback
+        ::posix_fadvise(getHandle(), readPos_, bytesRead, POSIX_FADV_DONTNEED); //best effort
+    readPos_ += bytesRead;
+
     return bytesRead; //"zero indicates end of file"
 }
 
@@ -145,15 +230,14 @@ size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, Erro
     */
 
     const size_t blockSize = getBlockSize();
-    assert(memBuf_.size() >= blockSize);
-    assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
+    assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= blockSize);
 
     auto       it    = static_cast<std::byte*>(buffer);
     const auto itEnd = it + bytesToRead;
     for (;;)
     {
         const size_t junkSize = std::min(static_cast<size_t>(itEnd - it), bufPosEnd_ - bufPos_);
-        std::memcpy(it, &memBuf_[0] + bufPos_ /*caveat: vector debug checks*/, junkSize);
+        std::memcpy(it, &memBuf_[0] + bufPos_, junkSize);
         bufPos_ += junkSize;
         it      += junkSize;
 
@@ -172,6 +256,36 @@ size_t FileInput::read(void* buffer, size_t bytesToRead) //throw FileError, Erro
     return it - static_cast<std::byte*>(buffer);
 }
 
+
+size_t FileInput::readAt(uint64_t offset, void* buffer, size_t bytesToRead) //throw FileError, X; return "bytesToRead" bytes unless end of file!
+{
+    std::byte*       it    = static_cast<std::byte*>(buffer);
+    std::byte* const itEnd = it + bytesToRead;
+
+    while (it != itEnd)
+    {
+        ssize_t bytesRead = 0;
+        do
+        {
+            bytesRead = ::pread(getHandle(), it, itEnd - it, offset + (it - static_cast<std::byte*>(buffer)));
+        }
+        while ((bytesRead < 0 && errno == EINTR) ||
+               (bytesRead < 0 && errno == EINVAL && disableDirectIO())); //O_DIRECT: caller's buffer and offset are not aligned
+
+        if (bytesRead < 0)
+            THROW_LAST_FILE_ERROR(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getFilePath())), L"pread");
+        if (bytesRead > itEnd - it) //better safe than sorry
+            throw FileError(replaceCpy(_("Cannot read file %x."), L"%x", fmtPath(getFilePath())), L"pread: buffer overflow."); //user should never see this
+
+        if (notifyUnbufferedIO_) notifyUnbufferedIO_(bytesRead); //throw X
+
+        if (bytesRead == 0) //end of file
+            break;
+        it += bytesRead;
+    }
+    return it - static_cast<std::byte*>(buffer);
+}
+
 //----------------------------------------------------------------------------------------------------
 
 namespace
@@ -200,11 +314,26 @@ FileBase::FileHandle openHandleForWrite(const Zstring& filePath, FileOutput::Acc
 
 
 FileOutput::FileOutput(FileHandle handle, const Zstring& filePath, const IOCallback& notifyUnbufferedIO) :
-    FileBase(handle, filePath), notifyUnbufferedIO_(notifyUnbufferedIO) {}
+    FileOutput(handle, filePath, IOProfile(), notifyUnbufferedIO) {}
+
+
+FileOutput::FileOutput(FileHandle handle, const Zstring& filePath, const IOProfile& profile, const IOCallback& notifyUnbufferedIO) :
+    FileBase(handle, filePath, profile), notifyUnbufferedIO_(notifyUnbufferedIO), writePos_(getStreamPosition(handle)) {}
+
+
+void FileOutput::syncStreamPosition()
+{
+    assert(bufPos_ == bufPosEnd_);
+    writePos_ = getStreamPosition(getHandle());
+}
 
 
 FileOutput::FileOutput(AccessFlag access, const Zstring& filePath, const IOCallback& notifyUnbufferedIO) :
-    FileBase(openHandleForWrite(filePath, access), filePath), notifyUnbufferedIO_(notifyUnbufferedIO) {} //throw FileError, ErrorTargetExisting
+    FileOutput(access, filePath, IOProfile(), notifyUnbufferedIO) {} //throw FileError, ErrorTargetExisting
+
+
+FileOutput::FileOutput(AccessFlag access, const Zstring& filePath, const IOProfile& profile, const IOCallback& notifyUnbufferedIO) :
+    FileBase(openHandleForWrite(filePath, access), filePath, profile), notifyUnbufferedIO_(notifyUnbufferedIO) {} //throw FileError, ErrorTargetExisting
 
 
 FileOutput::~FileOutput()
@@ -224,12 +353,16 @@ size_t FileOutput::tryWrite(const void* buffer, size_t bytesToWrite) //throw Fil
         throw std::logic_error("Contract violation! " + std::string(__FILE__) + ":" + numberTo<std::string>(__LINE__));
     assert(bytesToWrite <= getBlockSize());
 
+    if (bytesToWrite % DIRECT_IO_ALIGNMENT != 0 || reinterpret_cast<uintptr_t>(buffer) % DIRECT_IO_ALIGNMENT != 0)
+        disableDirectIO(); //O_DIRECT: write unaligned tail (or remainder of a short write) buffered
+
     ssize_t bytesWritten = 0;
     do
     {
         bytesWritten = ::write(getHandle(), buffer, bytesToWrite);
     }
-    while (bytesWritten < 0 && errno == EINTR);
+    while ((bytesWritten < 0 && errno == EINTR) ||
+           (bytesWritten < 0 && errno == EINVAL && disableDirectIO())); //O_DIRECT: file position not aligned, e.g. after kernel copy
     //write() on macOS: https://developer.apple.com/legacy/library/documentation/Darwin/Reference/ManPages/man2/write.2.html
 
     if (bytesWritten <= 0)
@@ -243,6 +376,11 @@ size_t FileOutput::tryWrite(const void* buffer, size_t bytesToWrite) //throw Fil
         throw FileError(replaceCpy(_("Cannot write file %x."), L"%x", fmtPath(getFilePath())), L"write: buffer overflow."); //user should never see this
 
     //if ::write() is interrupted (EINTR) right in the middle, it will return successfully with "bytesWritten < bytesToWrite"!
+
+    if (getProfile().dropPageCache)
+        pageCacheEvictor_.onWritten(writePos_, bytesWritten);
+    writePos_ += bytesWritten;
+
     return bytesWritten;
 }
 
@@ -250,15 +388,13 @@ size_t FileOutput::tryWrite(const void* buffer, size_t bytesToWrite) //throw Fil
 void FileOutput::write(const void* buffer, size_t bytesToWrite) //throw FileError, X
 {
     const size_t blockSize = getBlockSize();
-    assert(memBuf_.size() >= blockSize);
-    assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
+    assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= blockSize);
 
     auto       it    = static_cast<const std::byte*>(buffer);
     const auto itEnd = it + bytesToWrite;
     for (;;)
     {
-        if (memBuf_.size() - bufPos_ < blockSize) //support memBuf_.size() > blockSize to reduce memmove()s, but perf test shows: not really needed!
-            // || bufPos_ == bufPosEnd_) -> not needed while memBuf_.size() == blockSize
+        if (bufPos_ != 0) //buffer size > blockSize would reduce memmove()s, but perf test shows: not really needed!
         {
             std::memmove(&memBuf_[0], &memBuf_[0] + bufPos_, bufPosEnd_ - bufPos_);
             bufPosEnd_ -= bufPos_;
@@ -266,7 +402,7 @@ void FileOutput::write(const void* buffer, size_t bytesToWrite) //throw FileErro
         }
 
         const size_t junkSize = std::min(static_cast<size_t>(itEnd - it), blockSize - (bufPosEnd_ - bufPos_));
-        std::memcpy(&memBuf_[0] + bufPosEnd_ /*caveat: vector debug checks*/, it, junkSize);
+        std::memcpy(&memBuf_[0] + bufPosEnd_, it, junkSize);
         bufPosEnd_ += junkSize;
         it         += junkSize;
 
@@ -282,8 +418,7 @@ void FileOutput::write(const void* buffer, size_t bytesToWrite) //throw FileErro
 
 void FileOutput::flushBuffers() //throw FileError, X
 {
-    assert(bufPosEnd_ - bufPos_ <= getBlockSize());
-    assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= memBuf_.size());
+    assert(bufPos_ <= bufPosEnd_ && bufPosEnd_ <= getBlockSize());
     while (bufPos_ != bufPosEnd_)
     {
         const size_t bytesWritten = tryWrite(&memBuf_[bufPos_], bufPosEnd_ - bufPos_); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
@@ -296,6 +431,10 @@ void FileOutput::flushBuffers() //throw FileError, X
 void FileOutput::finalize() //throw FileError, X
 {
     flushBuffers(); //throw FileError, X
+
+    if (getProfile().dropPageCache)
+        pageCacheEvictor_.finish();
+
     //~FileBase() calls this one, too, but we want to propagate errors if any:
     close(); //throw FileError
 }
@@ -7,6 +7,7 @@
 #ifndef FILE_IO_H_89578342758342572345
 #define FILE_IO_H_89578342758342572345
 
+#include <memory>
 #include "file_error.h"
 #include "serialize.h"
 
@@ -15,6 +16,30 @@ namespace zen
 {
     const char LINE_BREAK[] = "\n"; //since OS X Apple uses newline, too
 
+const size_t DIRECT_IO_ALIGNMENT = 4096; //O_DIRECT: buffer address, file offset and length must be multiples of the logical block size
+
+
+struct IOProfile
+{
+    //Windows: use 64kB ?? https://technet.microsoft.com/en-us/library/cc938632
+    //Linux: use st_blksize?
+    //macOS: use f_iosize?
+    size_t blockSize = 128 * 1024;
+
+    //streaming huge files through the page cache evicts the working set of all other applications:
+    bool dropPageCache = false; //POSIX_FADV_DONTNEED on each block once processed
+    bool directIO      = false; //O_DIRECT: falls back to buffered I/O if not supported by file system, or for unaligned tail; blockSize must be aligned!
+};
+
+inline bool operator==(const IOProfile& lhs, const IOProfile& rhs)
+{
+    return lhs.blockSize     == rhs.blockSize     &&
+           lhs.dropPageCache == rhs.dropPageCache &&
+           lhs.directIO      == rhs.directIO;
+}
+inline bool operator!=(const IOProfile& lhs, const IOProfile& rhs) { return !(lhs == rhs); }
+
+
 /*
 OS-buffered file IO optimized for
     - sequential read/write accesses
@@ -31,24 +56,47 @@ public:
 
     FileHandle getHandle() { return fileHandle_; }
 
-    //Windows: use 64kB ?? https://technet.microsoft.com/en-us/library/cc938632
-    //Linux: use st_blksize?
-    //macOS: use f_iosize?
-    static size_t getBlockSize() { return 128 * 1024; };
+    size_t getBlockSize() const { return profile_.blockSize; }
+    const IOProfile& getProfile() const { return profile_; }
 
 protected:
-    FileBase(FileHandle handle, const Zstring& filePath) : fileHandle_(handle), filePath_(filePath) {}
+    FileBase(FileHandle handle, const Zstring& filePath, const IOProfile& profile);
     ~FileBase();
 
     void close(); //throw FileError -> optional, but good place to catch errors when closing stream!
     static const FileHandle invalidHandleValue;
 
+    using BlockBuffer = std::unique_ptr<std::byte[], void (*)(void*)>;
+    BlockBuffer allocateBlockBuffer() const; //aligned for O_DIRECT
+
+    bool disableDirectIO(); //return false if O_DIRECT was not set
+
 private:
     FileBase           (const FileBase&) = delete;
     FileBase& operator=(const FileBase&) = delete;
 
     FileHandle fileHandle_ = invalidHandleValue;
     const Zstring filePath_;
+    const IOProfile profile_;
+};
+
+//best effort: write back dirty pages of the range, then evict it from the page cache
+void evictPageCacheRange(FileBase::FileHandle fh, uint64_t offset, uint64_t length);
+
+
+//evict written data with a lag of one range: writeback of the last range overlaps with writing the next one
+class PageCacheEvictor
+{
+public:
+    explicit PageCacheEvictor(FileBase::FileHandle fh) : fh_(fh) {}
+
+    void onWritten(uint64_t offset, uint64_t length); //start writeback, evict range reported before
+    void finish();                                    //evict last range
+
+private:
+    const FileBase::FileHandle fh_;
+    uint64_t pendingOffset_ = 0;
+    uint64_t pendingLength_ = 0;
 };
 
 //-----------------------------------------------------------------------------------------------
@@ -57,18 +105,25 @@ class FileInput : public FileBase
 {
 public:
     FileInput(                   const Zstring& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/); //throw FileError, ErrorFileLocked
+    FileInput(                   const Zstring& filePath, const IOProfile& profile, const IOCallback& notifyUnbufferedIO /*throw X*/); //
     FileInput(FileHandle handle, const Zstring& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/); //takes ownership!
 
     size_t read(void* buffer, size_t bytesToRead); //throw FileError, ErrorFileLocked, X; return "bytesToRead" bytes unless end of stream!
 
+    //unbuffered positional read; doesn't change the stream position of read()
+    size_t readAt(uint64_t offset, void* buffer, size_t bytesToRead); //throw FileError, X; return "bytesToRead" bytes unless end of file!
+
+    void syncStreamPosition(); //after file position was moved via getHandle(), e.g. kernel copy; CONTRACT: nothing buffered
+
 private:
     size_t tryRead(void* buffer, size_t bytesToRead); //throw FileError, ErrorFileLocked; may return short, only 0 means EOF! =>  CONTRACT: bytesToRead > 0!
 
     const IOCallback notifyUnbufferedIO_; //throw X
 
-    std::vector<std::byte> memBuf_ = std::vector<std::byte>(getBlockSize());
+    const BlockBuffer memBuf_ = allocateBlockBuffer();
     size_t bufPos_   = 0;
     size_t bufPosEnd_= 0;
+    uint64_t readPos_ = 0; //dropPageCache: end of range already read
 };
 
 
@@ -81,7 +136,9 @@ public:
         ACC_CREATE_NEW
     };
     FileOutput(AccessFlag access, const Zstring& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/); //throw FileError, ErrorTargetExisting
+    FileOutput(AccessFlag access, const Zstring& filePath, const IOProfile& profile, const IOCallback& notifyUnbufferedIO /*throw X*/); //
     FileOutput(FileHandle handle, const Zstring& filePath, const IOCallback& notifyUnbufferedIO /*throw X*/); //takes ownership!
+    FileOutput(FileHandle handle, const Zstring& filePath, const IOProfile& profile, const IOCallback& notifyUnbufferedIO /*throw X*/); //
     ~FileOutput();
 
     void preAllocateSpaceBestEffort(uint64_t expectedSize); //throw FileError
@@ -90,14 +147,18 @@ public:
     void flushBuffers();                                 //throw FileError, X
     void finalize(); /*= flushBuffers() + close()*/      //throw FileError, X
 
+    void syncStreamPosition(); //after file position was moved via getHandle(), e.g. kernel copy; CONTRACT: nothing buffered
+
 private:
     size_t tryWrite(const void* buffer, size_t bytesToWrite); //throw FileError; may return short! CONTRACT: bytesToWrite > 0
 
     IOCallback notifyUnbufferedIO_; //throw X
 
-    std::vector<std::byte> memBuf_ = std::vector<std::byte>(getBlockSize());
+    const BlockBuffer memBuf_ = allocateBlockBuffer();
     size_t bufPos_    = 0;
     size_t bufPosEnd_ = 0;
+    uint64_t writePos_ = 0; //dropPageCache only
+    PageCacheEvictor pageCacheEvictor_{ getHandle() };
 };
 
 //-----------------------------------------------------------------------------------------------
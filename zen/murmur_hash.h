@@ -0,0 +1,151 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef MURMUR_HASH_H_8217430985710394
+#define MURMUR_HASH_H_8217430985710394
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+
+namespace zen
+{
+struct Hash128
+{
+    uint64_t low  = 0;
+    uint64_t high = 0;
+};
+inline bool operator==(const Hash128& lhs, const Hash128& rhs) { return lhs.low == rhs.low && lhs.high == rhs.high; }
+inline bool operator!=(const Hash128& lhs, const Hash128& rhs) { return !(lhs == rhs); }
+
+
+//incremental MurmurHash3_x64_128: https://github.com/aappleby/smhasher/blob/master/src/MurmurHash3.cpp
+//fast non-cryptographic hash => identify file content, but don't use against adversarial input!
+class MurmurHash3
+{
+public:
+    explicit MurmurHash3(uint32_t seed = 0) : h1_(seed), h2_(seed) {}
+
+    void update(const void* buffer, size_t bytes);
+    Hash128 finalize() const;
+
+private:
+    void processBlock(const std::byte* block);
+
+    static uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+    static uint64_t fmix64(uint64_t k)
+    {
+        k ^= k >> 33;
+        k *= 0xff51afd7ed558ccdULL;
+        k ^= k >> 33;
+        k *= 0xc4ceb9fe1a85ec53ULL;
+        k ^= k >> 33;
+        return k;
+    }
+
+    static uint64_t readLE64(const std::byte* ptr)
+    {
+        uint64_t val = 0;
+        std::memcpy(&val, ptr, sizeof(val)); //no alignment requirements; x86/ARM are little-endian
+        return val;
+    }
+
+    static const size_t BLOCK_SIZE = 16;
+    static const uint64_t C1 = 0x87c37b91114253d5ULL;
+    static const uint64_t C2 = 0x4cf5ad432745937fULL;
+
+    uint64_t h1_;
+    uint64_t h2_;
+    uint64_t totalBytes_ = 0;
+    std::byte tail_[BLOCK_SIZE] = {}; //partial block carried over to next update()
+    size_t tailSize_ = 0;
+};
+
+
+
+
+//------------------------- implementation -------------------------------
+inline
+void MurmurHash3::processBlock(const std::byte* block)
+{
+    uint64_t k1 = readLE64(block);
+    uint64_t k2 = readLE64(block + 8);
+
+    k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2; h1_ ^= k1;
+
+    h1_ = rotl64(h1_, 27); h1_ += h2_; h1_ = h1_ * 5 + 0x52dce729;
+
+    k2 *= C2; k2 = rotl64(k2, 33); k2 *= C1; h2_ ^= k2;
+
+    h2_ = rotl64(h2_, 31); h2_ += h1_; h2_ = h2_ * 5 + 0x38495ab5;
+}
+
+
+inline
+void MurmurHash3::update(const void* buffer, size_t bytes)
+{
+    const std::byte* it  = static_cast<const std::byte*>(buffer);
+    const std::byte* end = it + bytes;
+    totalBytes_ += bytes;
+
+    if (tailSize_ > 0)
+    {
+        const size_t fillSize = std::min(BLOCK_SIZE - tailSize_, bytes);
+        std::memcpy(tail_ + tailSize_, it, fillSize);
+        tailSize_ += fillSize;
+        it        += fillSize;
+
+        if (tailSize_ < BLOCK_SIZE)
+            return;
+        processBlock(tail_);
+        tailSize_ = 0;
+    }
+
+    for (; end - it >= static_cast<ptrdiff_t>(BLOCK_SIZE); it += BLOCK_SIZE)
+        processBlock(it);
+
+    std::memcpy(tail_, it, end - it);
+    tailSize_ = end - it;
+}
+
+
+inline
+Hash128 MurmurHash3::finalize() const
+{
+    uint64_t h1 = h1_;
+    uint64_t h2 = h2_;
+
+    uint64_t k1 = 0;
+    uint64_t k2 = 0;
+
+    for (size_t i = tailSize_; i-- > 8;)
+        k2 = (k2 << 8) | static_cast<uint8_t>(tail_[i]);
+    for (size_t i = std::min<size_t>(tailSize_, 8); i-- > 0;)
+        k1 = (k1 << 8) | static_cast<uint8_t>(tail_[i]);
+
+    if (tailSize_ > 8) { k2 *= C2; k2 = rotl64(k2, 33); k2 *= C1; h2 ^= k2; }
+    if (tailSize_ > 0) { k1 *= C1; k1 = rotl64(k1, 31); k1 *= C2; h1 ^= k1; }
+
+    h1 ^= totalBytes_;
+    h2 ^= totalBytes_;
+
+    h1 += h2;
+    h2 += h1;
+
+    h1 = fmix64(h1);
+    h2 = fmix64(h2);
+
+    h1 += h2;
+    h2 += h1;
+
+    return { h1, h2 };
+}
+}
+
+#endif //MURMUR_HASH_H_8217430985710394
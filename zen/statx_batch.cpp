@@ -0,0 +1,222 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#include "statx_batch.h"
+#include <cassert>
+#include <cstdint>
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <algorithm>
+
+    #include <unistd.h> //syscall
+    #include <sys/syscall.h>
+    #include <sys/mman.h>
+    #include <linux/io_uring.h>
+
+using namespace zen;
+
+
+namespace
+{
+/*  liburing is not needed for this little: http://kernel.dk/io_uring.pdf
+    ring buffers are shared with the kernel: producer publishes tail with release semantics, consumer reads it with acquire semantics */
+template <class T> inline T    loadAcquire (const T* ptr)        { return __atomic_load_n(ptr, __ATOMIC_ACQUIRE); }
+template <class T> inline void storeRelease(T* ptr, T value)     { __atomic_store_n(ptr, value, __ATOMIC_RELEASE); }
+
+
+class IoUringStatx
+{
+public:
+    IoUringStatx() //noexcept; check isValid()!
+    {
+        io_uring_params params = {};
+        ringFd_ = static_cast<int>(::syscall(__NR_io_uring_setup, RING_ENTRIES, &params));
+        if (ringFd_ < 0) //ENOSYS (kernel < 5.1), EPERM (disabled: sysctl kernel.io_uring_disabled, seccomp)
+        {
+            ringFd_ = -1;
+            return;
+        }
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        cqRingSize_ = params.cq_off.cqes  + params.cq_entries * sizeof(io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+        sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) { sqRing_ = nullptr; return; }
+
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+            cqRing_ = sqRing_;
+        else
+        {
+            cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) { cqRing_ = nullptr; return; }
+        }
+
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        sqes_ = static_cast<io_uring_sqe*>(::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES));
+        if (sqes_ == MAP_FAILED) { sqes_ = nullptr; return; }
+
+        auto sqField = [&](uint32_t offset) { return reinterpret_cast<unsigned int*>(static_cast<char*>(sqRing_) + offset); };
+        auto cqField = [&](uint32_t offset) { return reinterpret_cast<unsigned int*>(static_cast<char*>(cqRing_) + offset); };
+
+        sqTail_  = sqField(params.sq_off.tail);
+        sqMask_  = *sqField(params.sq_off.ring_mask);
+        sqArray_ = sqField(params.sq_off.array);
+        sqEntries_ = params.sq_entries;
+
+        cqHead_ = cqField(params.cq_off.head);
+        cqTail_ = cqField(params.cq_off.tail);
+        cqMask_ = *cqField(params.cq_off.ring_mask);
+        cqes_   = reinterpret_cast<io_uring_cqe*>(static_cast<char*>(cqRing_) + params.cq_off.cqes);
+
+        //IORING_OP_STATX needs Linux 5.6, just like IORING_REGISTER_PROBE
+        std::vector<std::byte> probeBuf(sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op));
+        auto probe = reinterpret_cast<io_uring_probe*>(&probeBuf[0]);
+        if (::syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == 0 &&
+            probe->last_op >= IORING_OP_STATX &&
+            (probe->ops[IORING_OP_STATX].flags & IO_URING_OP_SUPPORTED))
+            valid_ = true;
+    }
+
+    ~IoUringStatx()
+    {
+        if (sqes_)                         ::munmap(sqes_,  sqesSize_);
+        if (cqRing_ && cqRing_ != sqRing_) ::munmap(cqRing_, cqRingSize_);
+        if (sqRing_)                       ::munmap(sqRing_, sqRingSize_);
+        if (ringFd_ != -1)                 ::close(ringFd_);
+    }
+
+    bool isValid() const { return valid_; }
+
+    //return false on io_uring failure => caller falls back to synchronous statx()
+    bool run(StatxRequest* itFirst, StatxRequest* itLast) //noexcept
+    {
+        assert(valid_);
+        while (itFirst != itLast)
+        {
+            const unsigned int chunkSize = static_cast<unsigned int>(std::min<std::ptrdiff_t>(itLast - itFirst, sqEntries_)); //=> no CQ overflow: CQ has 2x SQ entries
+
+            unsigned int tail = *sqTail_; //only we write the tail
+            for (unsigned int i = 0; i < chunkSize; ++i, ++tail)
+            {
+                StatxRequest& req = itFirst[i];
+                const unsigned int idx = tail & sqMask_;
+
+                io_uring_sqe& sqe = sqes_[idx];
+                std::memset(&sqe, 0, sizeof(sqe));
+                sqe.opcode      = IORING_OP_STATX;
+                sqe.fd          = req.dirFd;
+                sqe.addr        = reinterpret_cast<uint64_t>(req.path);
+                sqe.len         = req.mask;
+                sqe.off         = reinterpret_cast<uint64_t>(&req.result);
+                sqe.statx_flags = static_cast<uint32_t>(req.flags);
+                sqe.user_data   = i;
+
+                sqArray_[idx] = idx;
+            }
+            storeRelease(sqTail_, tail);
+
+            for (unsigned int submitted = 0, completed = 0; completed < chunkSize;)
+            {
+                const long rv = ::syscall(__NR_io_uring_enter, ringFd_, chunkSize - submitted, chunkSize - completed, IORING_ENTER_GETEVENTS, nullptr, 0);
+                if (rv < 0)
+                {
+                    if (errno == EINTR)
+                        continue;
+                    //submitted SQEs still reference our buffers => must not return before they are completed
+                    if (submitted == 0 && completed == 0 && loadAcquire(cqTail_) == *cqHead_)
+                    {
+                        storeRelease(sqTail_, *sqTail_ - chunkSize); //nothing was consumed: withdraw
+                        return false;
+                    }
+                    valid_ = false; //broken ring: don't use anymore
+                    drain(chunkSize - completed);
+                    return false;
+                }
+                submitted += static_cast<unsigned int>(rv);
+
+                unsigned int head = *cqHead_; //only we write the head
+                for (const unsigned int cqTail = loadAcquire(cqTail_); head != cqTail; ++head, ++completed)
+                {
+                    const io_uring_cqe& cqe = cqes_[head & cqMask_];
+                    itFirst[cqe.user_data].errorCode = cqe.res < 0 ? -cqe.res : 0;
+                }
+                storeRelease(cqHead_, head);
+            }
+            itFirst += chunkSize;
+        }
+        return true;
+    }
+
+private:
+    IoUringStatx           (const IoUringStatx&) = delete;
+    IoUringStatx& operator=(const IoUringStatx&) = delete;
+
+    void drain(unsigned int pending) //best effort: wait until the kernel is done with our buffers
+    {
+        while (pending > 0)
+        {
+            if (::syscall(__NR_io_uring_enter, ringFd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && errno != EINTR)
+                return;
+
+            unsigned int head = *cqHead_;
+            for (const unsigned int cqTail = loadAcquire(cqTail_); head != cqTail && pending > 0; ++head)
+                --pending;
+            storeRelease(cqHead_, head);
+        }
+    }
+
+    static const unsigned int RING_ENTRIES = 128; //max. statx() in flight per thread
+
+    int ringFd_ = -1;
+    bool valid_ = false;
+
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned int* sqTail_  = nullptr;
+    unsigned int  sqMask_  = 0;
+    unsigned int* sqArray_ = nullptr;
+    unsigned int  sqEntries_ = 0;
+
+    unsigned int* cqHead_ = nullptr;
+    unsigned int* cqTail_ = nullptr;
+    unsigned int  cqMask_ = 0;
+    io_uring_cqe* cqes_   = nullptr;
+};
+}
+
+
+bool zen::statxBatch(std::vector<StatxRequest>& requests) //noexcept
+{
+    if (requests.empty())
+        return true;
+
+    if (requests.size() > 1) //don't bother for a single item
+    {
+        thread_local IoUringStatx ring; //=> one ring per (traverser worker) thread
+        if (ring.isValid() && ring.run(&requests[0], &requests[0] + requests.size()))
+            return true;
+    }
+
+    for (StatxRequest& req : requests)
+    {
+        req.errorCode = 0;
+        if (::statx(req.dirFd, req.path, req.flags, req.mask, &req.result) != 0)
+        {
+            if (errno == ENOSYS || errno == EPERM) //see tryGetItemDetailsStatx() in native.cpp
+                return false;
+            req.errorCode = errno;
+        }
+    }
+    return true;
+}
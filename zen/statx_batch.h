@@ -0,0 +1,37 @@
+// *****************************************************************************
+// * This file is part of the FreeFileSync project. It is distributed under    *
+// * GNU General Public License: https://www.gnu.org/licenses/gpl-3.0          *
+// * Copyright (C) Zenju (zenju AT freefilesync DOT org) - All Rights Reserved *
+// *****************************************************************************
+
+#ifndef STATX_BATCH_H_2380947523098457203
+#define STATX_BATCH_H_2380947523098457203
+
+#include <vector>
+    #include <fcntl.h> //AT_FDCWD
+    #include <sys/stat.h>
+
+
+namespace zen
+{
+struct StatxRequest
+{
+    int dirFd = AT_FDCWD;
+    const char* path = nullptr; //null-terminated
+    int flags = 0;              //AT_SYMLINK_NOFOLLOW, AT_STATX_DONT_SYNC, ...
+    unsigned int mask = 0;      //STATX_TYPE, STATX_MTIME, ...
+
+    struct ::statx result = {}; //output
+    int errorCode = 0;          //output: errno or 0 on success
+};
+
+/*  run many statx() calls concurrently without blocking one thread per call:
+      - io_uring (Linux 5.6+): submit the whole batch at once, the kernel completes them in parallel
+      - otherwise: fall back to sequential statx()
+    => each calling thread uses its own ring: no synchronization needed
+
+    returns false if statx() itself is not available (kernel < 4.11 or blocked by seccomp): errorCode is undefined! */
+bool statxBatch(std::vector<StatxRequest>& requests); //noexcept
+}
+
+#endif //STATX_BATCH_H_2380947523098457203
@@ -13,6 +13,8 @@
 #include <cwchar>  //swprintf
 #include <algorithm>
 #include <cassert>
+#include <cstring> //memcpy
+#include <cstdint>
 #include <vector>
 #include <sstream> //std::basic_ostringstream
 #include "stl_tools.h"
@@ -27,6 +29,7 @@ template <class Char> bool isDigit     (Char c); //not exactly the same as "std:
 template <class Char> bool isHexDigit  (Char c);
 template <class Char> bool isAsciiAlpha(Char c);
 template <class Char> bool isAsciiString(const Char* str);
+template <class Char> bool isAsciiString(const Char* str, size_t len); //faster: checks a machine word at a time
 template <class Char> Char asciiToLower(Char c);
 template <class Char> Char asciiToUpper(Char c);
 
@@ -153,6 +156,28 @@ bool isAsciiString(const Char* str)
 }
 
 
+template <class Char> inline
+bool isAsciiString(const Char* str, size_t len)
+{
+    static_assert(std::is_same_v<Char, char> || std::is_same_v<Char, wchar_t>);
+    const Char* const strEnd = str + len;
+
+    if constexpr (sizeof(Char) == 1)
+        for (; strEnd - str >= 8; str += 8)
+        {
+            uint64_t block = 0;
+            std::memcpy(&block, str, 8); //no alignment requirements, compiles to a single load
+            if (block & 0x8080808080808080ULL)
+                return false;
+        }
+
+    for (; str != strEnd; ++str)
+        if (zen::makeUnsigned(*str) >= 128)
+            return false;
+    return true;
+}
+
+
 template <class Char> inline
 Char asciiToLower(Char c)
 {
@@ -14,13 +14,71 @@
 using namespace zen;
 
 
+namespace
+{
+//g_unichar_toupper() is a function call + multi-level table lookup per code point
+// => pre-compute the 2-byte UTF-8 range (Latin, Greek, Cyrillic, Armenian, Hebrew, Arabic): 8 KB, fits into L1 cache
+constexpr impl::CodePoint UPPER_CASE_TABLE_SIZE = 0x800;
+
+impl::CodePoint toUpperCase(impl::CodePoint cp)
+{
+    static_assert(sizeof(impl::CodePoint) == sizeof(gunichar));
+
+    if (cp < 128)
+        return asciiToUpper(cp);
+
+    if (cp < UPPER_CASE_TABLE_SIZE)
+    {
+        static const std::vector<impl::CodePoint> upperCaseTable = [] //thread-safe init
+        {
+            std::vector<impl::CodePoint> table(UPPER_CASE_TABLE_SIZE);
+            for (impl::CodePoint i = 0; i < UPPER_CASE_TABLE_SIZE; ++i)
+                table[i] = ::g_unichar_toupper(i);
+            return table;
+        }();
+        return upperCaseTable[cp];
+    }
+    return ::g_unichar_toupper(cp); //don't use std::towupper: *incomplete* and locale-dependent!
+}
+}
+
+
+bool makeUpperAscii(const Zchar* str, size_t len, Zchar* buf)
+{
+    static_assert(sizeof(Zchar) == 1);
+    const Zchar* const strEnd = str + len;
+
+    for (; strEnd - str >= 8; str += 8, buf += 8)
+    {
+        uint64_t block = 0;
+        std::memcpy(&block, str, 8);
+        if (block & 0x8080808080808080ULL)
+            return false;
+
+        //set high bit for each byte in range [a-z]: no carry into neighboring bytes for ASCII input
+        const uint64_t lowerCase = (block + 0x1f1f1f1f1f1f1f1fULL) & ~(block + 0x0505050505050505ULL) & 0x8080808080808080ULL;
+        block ^= lowerCase >> 2; //0x80 >> 2 == 'a' - 'A'
+        std::memcpy(buf, &block, 8);
+    }
+
+    for (; str != strEnd; ++str, ++buf)
+    {
+        if (makeUnsigned(*str) >= 128)
+            return false;
+        *buf = asciiToUpper(*str);
+    }
+    return true;
+}
+
+
 Zstring makeUpperCopy(const Zstring& str)
 {
     //fast pre-check:
-    if (isAsciiString(str.c_str())) //perf: in the range of 3.5ns
+    if (isAsciiString(str.c_str(), str.size()))
     {
         Zstring output = str;
-        for (Zchar& c : output) c = asciiToUpper(c);
+        [[maybe_unused]] const bool isAscii = makeUpperAscii(str.c_str(), str.size(), output.begin()); //begin(): make unshared
+        assert(isAscii);
         return output;
     }
 
@@ -33,7 +91,7 @@ Zstring makeUpperCopy(const Zstring& str)
 
         impl::UtfDecoder<char> decoder(strNorm.c_str(), strNorm.size());
         while (const std::optional<impl::CodePoint> cp = decoder.getNext())
-            impl::codePointToUtf<char>(::g_unichar_toupper(*cp), [&](char c) { output += c; }); //don't use std::towupper: *incomplete* and locale-dependent!
+            impl::codePointToUtf<char>(toUpperCase(*cp), [&](char c) { output += c; });
 
         return output;
 
@@ -50,7 +108,7 @@ Zstring makeUpperCopy(const Zstring& str)
 Zstring getUnicodeNormalForm(const Zstring& str)
 {
     //fast pre-check:
-    if (isAsciiString(str.c_str())) //perf: in the range of 3.5ns
+    if (isAsciiString(str.c_str(), str.size()))
         return str; //god bless our ref-counting! => save output string memory consumption!
 
     //Example: const char* decomposed  = "\x6f\xcc\x81";
@@ -150,10 +208,8 @@ int compareNoCaseUtf8(const char* lhs, size_t lhsLen, const char* rhs, size_t rh
         if (!cpL || !cpR)
             return static_cast<int>(!cpR) - static_cast<int>(!cpL);
 
-        static_assert(sizeof(gunichar) == sizeof(impl::CodePoint));
-
-        const gunichar charL = ::g_unichar_toupper(*cpL); //note: tolower can be ambiguous, so don't use:
-        const gunichar charR = ::g_unichar_toupper(*cpR); //e.g. "Σ" (upper case) can be lower-case "ς" in the end of the word or "σ" in the middle.
+        const impl::CodePoint charL = toUpperCase(*cpL); //note: tolower can be ambiguous, so don't use:
+        const impl::CodePoint charR = toUpperCase(*cpR); //e.g. "Σ" (upper case) can be lower-case "ς" in the end of the word or "σ" in the middle.
         if (charL != charR)
             //ordering: "to lower" converts to higher code points than "to upper"
             return static_cast<unsigned int>(charL) - static_cast<unsigned int>(charR); //unsigned char-comparison is the convention!
@@ -164,6 +220,44 @@ int compareNoCaseUtf8(const char* lhs, size_t lhsLen, const char* rhs, size_t rh
 }
 
 
+int compareNoCase(const Zstring& lhs, const Zstring& rhs)
+{
+    //fast path: fold ASCII chars on the fly
+    size_t pos = 0;
+    for (;; ++pos)
+    {
+        if (pos == lhs.size() || pos == rhs.size())
+            return static_cast<int>(pos != lhs.size()) - static_cast<int>(pos != rhs.size());
+        //note: even if the remaining chars are combining marks for the last char, "nothing" still sorts before "something", since ASCII < non-ASCII
+
+        const Zchar charL = lhs[pos];
+        const Zchar charR = rhs[pos];
+        if (makeUnsigned(charL) >= 128 || makeUnsigned(charR) >= 128)
+        {
+            if (pos > 0) //non-ASCII char might be a combining mark for the preceding char => Unicode-normalize both
+                --pos;
+            break;
+        }
+
+        const Zchar upperL = asciiToUpper(charL);
+        const Zchar upperR = asciiToUpper(charR);
+        if (upperL != upperR)
+        {
+            auto isNonAscii = [](const Zstring& str, size_t i) { return i < str.size() && makeUnsigned(str[i]) >= 128; };
+            if (isNonAscii(lhs, pos + 1) || isNonAscii(rhs, pos + 1))
+                break;
+            return static_cast<int>(makeUnsigned(upperL)) - static_cast<int>(makeUnsigned(upperR));
+        }
+    }
+
+    //non-ASCII (rare): needs memory allocation for Unicode normalization
+    const Zstring& lhsNorm = getUnicodeNormalForm(Zstring(lhs.begin() + pos, lhs.end()));
+    const Zstring& rhsNorm = getUnicodeNormalForm(Zstring(rhs.begin() + pos, rhs.end()));
+
+    return compareNoCaseUtf8(lhsNorm.c_str(), lhsNorm.size(), rhsNorm.c_str(), rhsNorm.size());
+}
+
+
 int compareNatural(const Zstring& lhs, const Zstring& rhs)
 {
     //Unicode normal forms:
@@ -29,6 +29,10 @@ using Zstringw = zen::Zbase<wchar_t>;
 // - output is Unicode-normalized
 Zstring makeUpperCopy(const Zstring& str);
 
+//allocation-free alternative for hot code paths: upper-case ASCII-only input into caller-provided buffer of "len" chars (no 0-termination)
+//  returns false if input contains non-ASCII chars => buffer content is undefined, use makeUpperCopy()
+bool makeUpperAscii(const Zchar* str, size_t len, Zchar* buf);
+
 //Windows, Linux: precomposed
 //macOS: decomposed
 Zstring getUnicodeNormalForm(const Zstring& str);
@@ -38,11 +42,22 @@ Zstring getUnicodeNormalForm(const Zstring& str);
 
 struct LessUnicodeNormal { bool operator()(const Zstring& lhs, const Zstring& rhs) const { return getUnicodeNormalForm(lhs) < getUnicodeNormalForm(rhs);} };
 
+struct ZstringNorm //use as STL container key: avoid needless Unicode normalizations during std::map<>::find() (same order as LessUnicodeNormal)
+{
+    ZstringNorm(const Zstring& str) : orig(str), norm(getUnicodeNormalForm(str)) {} //ASCII: no extra memory, thanks to ref-counting
+    Zstring orig;
+    Zstring norm;
+};
+inline bool operator<(const ZstringNorm& lhs, const ZstringNorm& rhs) { return lhs.norm < rhs.norm; }
+
 Zstring replaceCpyAsciiNoCase(const Zstring& str, const Zstring& oldTerm, const Zstring& newTerm);
 
 //------------------------------------------------------------------------------------------
 
-inline bool equalNoCase(const Zstring& lhs, const Zstring& rhs) { return makeUpperCopy(lhs) == makeUpperCopy(rhs); }
+//same ordering as compareString(makeUpperCopy(lhs), makeUpperCopy(rhs)), but case is folded on the fly: no memory allocation for ASCII
+int compareNoCase(const Zstring& lhs, const Zstring& rhs);
+
+inline bool equalNoCase(const Zstring& lhs, const Zstring& rhs) { return compareNoCase(lhs, rhs) == 0; }
 
 struct ZstringNoCase //use as STL container key: avoid needless upper-case conversions during std::map<>::find()
 {